@@ -0,0 +1,114 @@
+#pragma once
+#ifndef ALIGNED_ARRAY_HPP
+#define ALIGNED_ARRAY_HPP
+
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+#include "array.hpp"
+
+// Cache line size of the x86-64 and most ARM cores, the default alignment of AlignedArray.
+inline constexpr size_t kArrayCacheLine = 64;
+
+// Default slot size of PaddedArray. Intel cores prefetch cache lines in aligned pairs, so writes to neighbouring lines
+// still contend; two lines keep the slots of different threads apart on those as well.
+inline constexpr size_t kArrayFalseSharingRange = 2 * kArrayCacheLine;
+
+// Array whose storage starts on an Align-byte boundary (a cache line by default), so that vector loads and stores of
+// up to Align bytes at multiples of Align from Data() never split a line. Still an aggregate; its size is rounded up
+// to a multiple of Align. Data() tells the compiler about the alignment through std::assume_aligned.
+template <class T, size_t N, size_t Align = kArrayCacheLine>
+class alignas(Align) AlignedArray : public Array<T, N> {
+  static_assert(std::has_single_bit(Align) && Align >= alignof(T),
+                "Align must be a power of two and at least the alignment of T");
+
+ public:
+  constexpr T* Data() {
+    return std::assume_aligned<Align>(this->data);
+  }
+
+  constexpr const T* Data() const {
+    return std::assume_aligned<Align>(this->data);
+  }
+};
+
+// A single element of PaddedArray, alone in its Align-byte slot.
+template <class T, size_t Align>
+struct alignas(Align) PaddedSlot {
+  T value;
+};
+
+// Array of N elements that each own a slot of Align bytes (kArrayFalseSharingRange by default), for per-thread
+// counters and other state that different cores write at the same time: with the elements sharing no cache line, a
+// write on one core never invalidates the line another core works on. The elements are not contiguous, so there is no
+// Data(). An aggregate of PaddedSlots, initialized as PaddedArray<int, 2>{{{1}, {2}}}.
+template <class T, size_t N, size_t Align = kArrayFalseSharingRange>
+class PaddedArray {
+  static_assert(std::has_single_bit(Align) && Align >= alignof(T),
+                "Align must be a power of two and at least the alignment of T");
+
+ public:
+  constexpr T& operator[](size_t index) {
+    return slots[index].value;
+  }
+
+  constexpr const T& operator[](size_t index) const {
+    return slots[index].value;
+  }
+
+  constexpr T& At(size_t index) {
+    if (index >= N) {
+      throw ArrayOutOfRange{};
+    }
+    return slots[index].value;
+  }
+
+  constexpr const T& At(size_t index) const {
+    if (index >= N) {
+      throw ArrayOutOfRange{};
+    }
+    return slots[index].value;
+  }
+
+  constexpr T& Front() {
+    return slots[0].value;
+  }
+
+  constexpr const T& Front() const {
+    return slots[0].value;
+  }
+
+  constexpr T& Back() {
+    return slots[N - 1].value;
+  }
+
+  constexpr const T& Back() const {
+    return slots[N - 1].value;
+  }
+
+  constexpr size_t Size() const {
+    return N;
+  }
+
+  constexpr bool Empty() const {
+    return N == 0;
+  }
+
+  constexpr void Fill(const T& value) {
+    for (auto& slot : slots) {
+      slot.value = value;
+    }
+  }
+
+  constexpr void Swap(PaddedArray<T, N, Align>& other) {
+    for (size_t i = 0; i < N; ++i) {
+      std::swap(slots[i].value, other.slots[i].value);
+    }
+  }
+
+  PaddedSlot<T, Align> slots[N];
+};
+
+#endif
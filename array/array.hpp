@@ -1,4 +1,20 @@
+#pragma once
+#ifndef ARRAY_HPP
+#define ARRAY_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <numeric>
 #include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define ARRAY_STREAMING_STORES 1
+#endif
 
 class ArrayOutOfRange : public std::out_of_range {
  public:
@@ -6,4 +22,243 @@ class ArrayOutOfRange : public std::out_of_range {
   }
 };
 
-// YOUR CODE ...
+// Fill of trivially copyable elements writes buffers of at least ARRAY_NON_TEMPORAL_BYTES with non-temporal stores,
+// which go to memory without first reading every line into the cache and without evicting what is there. Set it to
+// the last level cache size of the target machine; 0 turns the streaming stores off.
+#ifndef ARRAY_NON_TEMPORAL_BYTES
+#define ARRAY_NON_TEMPORAL_BYTES (size_t{8} << 20)
+#endif
+
+inline constexpr size_t kArrayNonTemporalBytes = ARRAY_NON_TEMPORAL_BYTES;
+static_assert(kArrayNonTemporalBytes == 0 || kArrayNonTemporalBytes >= 16,
+              "ARRAY_NON_TEMPORAL_BYTES must be 0 or at least one 16-byte streaming store");
+
+// Function multiversioning for the vector kernels: an AVX2 clone moves a block in two 32-byte registers instead of four
+// 16-byte ones, and SSE4.1 brings the vector min and max of 32-bit integers. Clang does not accept target_clones on
+// templates.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define ARRAY_MULTIVERSION __attribute__((target_clones("avx2", "sse4.1", "default")))
+#else
+#define ARRAY_MULTIVERSION
+#endif
+
+namespace array_internal {
+
+// The block kernels move a cache line at a time. Within a block they copy 64-bit words, or bytes when the block is no
+// multiple of 8 bytes, in a loop of fixed length that the compiler turns into full-width vector loads and stores.
+inline constexpr size_t kBlockBytes = 64;
+
+template <class T>
+inline constexpr size_t kBlockElements = std::max<size_t>(1, kBlockBytes / sizeof(T));
+
+template <class T>
+using BlockWord = std::conditional_t<kBlockElements<T> * sizeof(T) % sizeof(uint64_t) == 0, uint64_t, unsigned char>;
+
+template <class T>
+ARRAY_MULTIVERSION void BlockFill(T* data, size_t size, const T& value) {
+  using Word = BlockWord<T>;
+  constexpr auto kWords = kBlockElements<T> * sizeof(T) / sizeof(Word);
+  Word block[kWords];
+  for (size_t i = 0; i < kBlockElements<T>; ++i) {
+    std::memcpy(reinterpret_cast<unsigned char*>(block) + i * sizeof(T), &value, sizeof(T));
+  }
+  auto* bytes = reinterpret_cast<unsigned char*>(data);
+  size_t i = 0;
+  for (; i + kBlockElements<T> <= size; i += kBlockElements<T>) {
+    for (size_t j = 0; j < kWords; ++j) {
+      std::memcpy(bytes + i * sizeof(T) + j * sizeof(Word), &block[j], sizeof(Word));
+    }
+  }
+  for (; i < size; ++i) {
+    std::memcpy(data + i, &value, sizeof(T));
+  }
+}
+
+template <class T>
+ARRAY_MULTIVERSION void BlockSwap(T* __restrict x, T* __restrict y, size_t size) {
+  using Word = BlockWord<T>;
+  constexpr auto kWords = kBlockElements<T> * sizeof(T) / sizeof(Word);
+  auto* x_bytes = reinterpret_cast<unsigned char*>(x);
+  auto* y_bytes = reinterpret_cast<unsigned char*>(y);
+  size_t i = 0;
+  for (; i + kBlockElements<T> <= size; i += kBlockElements<T>) {
+    for (size_t j = 0; j < kWords; ++j) {
+      const auto offset = i * sizeof(T) + j * sizeof(Word);
+      Word x_word;
+      Word y_word;
+      std::memcpy(&x_word, x_bytes + offset, sizeof(Word));
+      std::memcpy(&y_word, y_bytes + offset, sizeof(Word));
+      std::memcpy(x_bytes + offset, &y_word, sizeof(Word));
+      std::memcpy(y_bytes + offset, &x_word, sizeof(Word));
+    }
+  }
+  for (; i < size; ++i) {
+    unsigned char element[sizeof(T)];
+    std::memcpy(element, x + i, sizeof(T));
+    std::memcpy(x + i, y + i, sizeof(T));
+    std::memcpy(y + i, element, sizeof(T));
+  }
+}
+
+#ifdef ARRAY_STREAMING_STORES
+// Streaming stores take aligned 16-byte chunks, which cut through the elements unless sizeof(T) divides 16, so the
+// buffer is written as the bytes of value repeated: those repeat every lcm(sizeof(T), 16) bytes, and the chunk at byte
+// offset o is the 16 bytes of that period starting at o mod period. The unaligned head and the tail go through memcpy.
+template <class T>
+void StreamFill(T* data, size_t size, const T& value) {
+  constexpr auto kPeriod = std::lcm(sizeof(T), size_t{16});
+  // Two periods, so that the chunk starting at any phase of the first one is contiguous.
+  alignas(16) unsigned char pattern[2 * kPeriod];
+  for (size_t offset = 0; offset < sizeof(pattern); offset += sizeof(T)) {
+    std::memcpy(pattern + offset, &value, sizeof(T));
+  }
+  auto* bytes = reinterpret_cast<unsigned char*>(data);
+  const auto total = size * sizeof(T);
+  const auto head = std::min<size_t>((16 - reinterpret_cast<uintptr_t>(bytes) % 16) % 16, total);
+  std::memcpy(bytes, pattern, head);
+  auto offset = head;
+  auto phase = head % kPeriod;
+  for (; offset + 16 <= total; offset += 16) {
+    const auto chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pattern + phase));
+    _mm_stream_si128(reinterpret_cast<__m128i*>(bytes + offset), chunk);
+    phase = phase + 16 < kPeriod ? phase + 16 : phase + 16 - kPeriod;
+  }
+  // Streaming stores are weakly ordered; the fence makes them visible before anything stored after Fill.
+  _mm_sfence();
+  std::memcpy(bytes + offset, pattern + phase, total - offset);
+}
+#endif
+
+}  // namespace array_internal
+
+// Fixed-size array: an aggregate whose only member is the C array itself, so that it is as large as T[N] and can be
+// initialized with braces like one.
+template <class T, size_t N>
+class Array {
+ public:
+  constexpr T& operator[](size_t index) {
+    return data[index];
+  }
+
+  constexpr const T& operator[](size_t index) const {
+    return data[index];
+  }
+
+  constexpr T& At(size_t index) {
+    if (index >= N) {
+      throw ArrayOutOfRange{};
+    }
+    return data[index];
+  }
+
+  constexpr const T& At(size_t index) const {
+    if (index >= N) {
+      throw ArrayOutOfRange{};
+    }
+    return data[index];
+  }
+
+  constexpr T& Front() {
+    return data[0];
+  }
+
+  constexpr const T& Front() const {
+    return data[0];
+  }
+
+  constexpr T& Back() {
+    return data[N - 1];
+  }
+
+  constexpr const T& Back() const {
+    return data[N - 1];
+  }
+
+  constexpr T* Data() {
+    return data;
+  }
+
+  constexpr const T* Data() const {
+    return data;
+  }
+
+  constexpr size_t Size() const {
+    return N;
+  }
+
+  constexpr bool Empty() const {
+    return N == 0;
+  }
+
+  // Trivially copyable elements are written a block of copies at a time, and buffers of kArrayNonTemporalBytes and
+  // more with streaming stores.
+  constexpr void Fill(const T& value) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (!std::is_constant_evaluated()) {
+#ifdef ARRAY_STREAMING_STORES
+        if constexpr (kArrayNonTemporalBytes != 0 && N * sizeof(T) >= kArrayNonTemporalBytes && sizeof(T) <= 64) {
+          array_internal::StreamFill(data, N, value);
+          return;
+        }
+#endif
+        array_internal::BlockFill(data, N, value);
+        return;
+      }
+    }
+    for (auto& element : data) {
+      element = value;
+    }
+  }
+
+  // Trivially copyable elements are exchanged a block of machine words at a time.
+  constexpr void Swap(Array<T, N>& other) {
+    if constexpr (std::is_trivially_copyable_v<T>) {
+      if (!std::is_constant_evaluated()) {
+        if (this != &other) {
+          array_internal::BlockSwap(data, other.data, N);
+        }
+        return;
+      }
+    }
+    for (size_t i = 0; i < N; ++i) {
+      std::swap(data[i], other.data[i]);
+    }
+  }
+
+  T data[N];
+};
+
+// Number of elements of a C array along its first dimension, 0 for anything else.
+template <class T>
+constexpr size_t GetSize(const T&) {
+  return 0;
+}
+
+template <class T, size_t N>
+constexpr size_t GetSize(const T (&)[N]) {
+  return N;
+}
+
+// Number of dimensions of a C array, 0 for anything else.
+template <class T>
+constexpr size_t GetRank(const T&) {
+  return 0;
+}
+
+template <class T, size_t N>
+constexpr size_t GetRank(const T (&array)[N]) {
+  return 1 + GetRank(array[0]);
+}
+
+// Number of elements of a C array over all of its dimensions; anything else counts as a single element.
+template <class T>
+constexpr size_t GetNumElements(const T&) {
+  return 1;
+}
+
+template <class T, size_t N>
+constexpr size_t GetNumElements(const T (&array)[N]) {
+  return N * GetNumElements(array[0]);
+}
+
+#endif
@@ -3,9 +3,21 @@
 
 #include "array.hpp"
 #include "array.hpp"  // check include guards
+#include "aligned_array.hpp"
+#include "aligned_array.hpp"  // check include guards
+#include "sort.hpp"
+#include "sort.hpp"  // check include guards
 
+#include <algorithm>
 #include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
 #include <utility>
+#include <vector>
 
 template <class T, class U>
 inline constexpr auto kSwappable = requires(T t, U u) {
@@ -152,6 +164,212 @@ TEST_CASE("Swap", "[Array]") {
   static_assert(!kSwappable<Array<int, 3>, Array<int, 4>>, "Arrays of different sizes must not be swappable");
 }
 
+TEST_CASE("Fill Large", "[Array]") {
+  // Past kArrayNonTemporalBytes the buffer is written with streaming stores.
+  constexpr size_t kSize = kArrayNonTemporalBytes / sizeof(uint32_t) + 5;
+  const auto a = std::make_unique<Array<uint32_t, kSize>>();
+  a->Fill(0xdeadbeef);
+  REQUIRE(std::count(a->Data(), a->Data() + kSize, 0xdeadbeef) == kSize);
+
+  // Elements of a size that does not divide the 16-byte chunks, starting off their alignment.
+  struct Triple {
+    uint8_t x, y, z;
+  };
+  struct Shifted {
+    char pad;
+    Array<Triple, kArrayNonTemporalBytes / sizeof(Triple) + 7> array;
+  };
+  const auto shifted = std::make_unique<Shifted>();
+  for (size_t repeat = 0; repeat < 2; ++repeat) {
+    shifted->array.Fill(Triple{1, static_cast<uint8_t>(2 + repeat), 3});
+    const auto* data = shifted->array.Data();
+    REQUIRE(std::all_of(data, data + shifted->array.Size(), [&](const Triple& element) {
+      return element.x == 1 && element.y == 2 + repeat && element.z == 3;
+    }));
+  }
+  REQUIRE(shifted->pad == '\0');
+
+  // Below that, a block of copies at a time with an element-wise tail.
+  Array<int64_t, 1001> b{};
+  b.Fill(-7);
+  REQUIRE(std::count(b.Data(), b.Data() + b.Size(), -7) == 1001);
+}
+
+TEST_CASE("Swap Large", "[Array]") {
+  constexpr size_t kSize = 100003;
+  const auto a = std::make_unique<Array<int16_t, kSize>>();
+  const auto b = std::make_unique<Array<int16_t, kSize>>();
+  for (size_t i = 0; i < kSize; ++i) {
+    (*a)[i] = static_cast<int16_t>(i);
+    (*b)[i] = static_cast<int16_t>(-static_cast<int>(i % 1000));
+  }
+  a->Swap(*b);
+  size_t mismatches = 0;
+  for (size_t i = 0; i < kSize; ++i) {
+    mismatches += (*a)[i] != -static_cast<int>(i % 1000) || (*b)[i] != static_cast<int16_t>(i);
+  }
+  REQUIRE(mismatches == 0);
+  a->Swap(*a);
+  REQUIRE((*a)[kSize - 1] == -static_cast<int>((kSize - 1) % 1000));
+}
+
+TEST_CASE("AlignedArray", "[AlignedArray]") {
+  static_assert(std::is_aggregate_v<AlignedArray<int, 3>>);
+  static_assert(alignof(AlignedArray<char, 3>) == kArrayCacheLine);
+  static_assert(sizeof(AlignedArray<char, 3>) == kArrayCacheLine);
+  static_assert(sizeof(AlignedArray<double, 16>) == sizeof(double[16]));
+  static_assert(alignof(AlignedArray<float, 8, 32>) == 32);
+
+  auto a = AlignedArray<int, 5>{1, 2, 3};
+  Equals(a, std::array{1, 2, 3, 0, 0});
+  REQUIRE(reinterpret_cast<uintptr_t>(a.Data()) % kArrayCacheLine == 0);
+  REQUIRE(std::as_const(a).Data() == &a[0]);
+  REQUIRE(a.At(4) == 0);
+  REQUIRE_THROWS_AS(a.At(5), ArrayOutOfRange);
+
+  // Also on the heap, and off its alignment inside another object.
+  struct Shifted {
+    char pad;
+    AlignedArray<uint8_t, 100, 256> array;
+  };
+  const auto shifted = std::make_unique<Shifted>();
+  REQUIRE(reinterpret_cast<uintptr_t>(shifted->array.Data()) % 256 == 0);
+  shifted->array.Fill(7);
+  REQUIRE(std::count(shifted->array.Data(), shifted->array.Data() + 100, 7) == 100);
+
+  auto b = AlignedArray<int, 5>{5, 4, 3, 2, 1};
+  a.Swap(b);
+  Equals(a, std::array{5, 4, 3, 2, 1});
+  Equals(b, std::array{1, 2, 3, 0, 0});
+}
+
+TEST_CASE("PaddedArray", "[AlignedArray]") {
+  static_assert(std::is_aggregate_v<PaddedArray<int, 3>>);
+  static_assert(sizeof(PaddedArray<int, 3>) == 3 * kArrayFalseSharingRange);
+  static_assert(sizeof(PaddedArray<char, 4, 64>) == 4 * 64);
+  static_assert(sizeof(PaddedArray<char[100], 2, 64>) == 2 * 128);
+
+  auto a = PaddedArray<int, 3>{{{1}, {2}}};
+  REQUIRE(a.Size() == 3);
+  REQUIRE_FALSE(a.Empty());
+  REQUIRE(std::as_const(a).Front() == 1);
+  REQUIRE(a[1] == 2);
+  REQUIRE(a.Back() == 0);
+  REQUIRE_THROWS_AS(std::as_const(a).At(3), ArrayOutOfRange);  // NOLINT
+  for (size_t i = 0; i < a.Size(); ++i) {
+    REQUIRE(reinterpret_cast<uintptr_t>(&a[i]) % kArrayFalseSharingRange == 0);
+  }
+  static_assert(std::is_same_v<decltype(std::as_const(a)[0]), const int&>);
+
+  a.Fill(9);
+  auto b = PaddedArray<int, 3>{{{4}, {5}, {6}}};
+  a.Swap(b);
+  REQUIRE((a[0] == 4 && a[1] == 5 && a[2] == 6));
+  REQUIRE((b[0] == 9 && b[1] == 9 && b[2] == 9));
+  static_assert(!kSwappable<PaddedArray<int, 3>, PaddedArray<int, 3, 64>>);
+
+  // Per-thread counters, each written by its own thread only.
+  constexpr size_t kThreads = 4;
+  constexpr uint64_t kIncrements = 10000;
+  PaddedArray<std::atomic<uint64_t>, kThreads> counters{};
+  std::vector<std::thread> threads;
+  for (size_t t = 0; t < kThreads; ++t) {
+    threads.emplace_back([&counters, t] {
+      for (uint64_t i = 0; i <= t * kIncrements; ++i) {
+        counters[t].fetch_add(1, std::memory_order_relaxed);
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+  for (size_t t = 0; t < kThreads; ++t) {
+    REQUIRE(counters[t].load() == t * kIncrements + 1);
+  }
+}
+
+template <size_t N>
+void CheckSortingNetwork() {
+  // By the 0-1 principle a network that sorts every sequence of zeros and ones sorts everything.
+  if constexpr (N <= 16) {
+    for (uint32_t bits = 0; bits < (uint32_t{1} << N); ++bits) {
+      Array<uint8_t, N> a{};
+      for (size_t i = 0; i < N; ++i) {
+        a[i] = bits >> i & 1;
+      }
+      Sort(a);
+      REQUIRE(std::is_sorted(a.Data(), a.Data() + N));
+    }
+  }
+  std::mt19937 gen(static_cast<uint32_t>(N));
+  for (int repeat = 0; repeat < 100; ++repeat) {
+    Array<int, N> a{};
+    for (auto& element : a.data) {
+      element = static_cast<int>(gen() % 50) - 25;
+    }
+    auto expected = a;
+    std::sort(expected.Data(), expected.Data() + N);
+    Sort(a);
+    REQUIRE(std::equal(a.Data(), a.Data() + N, expected.Data()));
+  }
+}
+
+template <size_t... kSizes>
+void CheckSortingNetworks(std::index_sequence<kSizes...>) {
+  (CheckSortingNetwork<kSizes + 1>(), ...);
+}
+
+TEST_CASE("Sort", "[Sort]") {
+  static_assert(array_internal::kSortingNetwork<8>.size() == 19);
+  static_assert(array_internal::kSortingNetwork<16>.size() == 63);
+  static_assert(array_internal::kSortingNetwork<32>.size() == 191);
+  static_assert([] {
+    Array<int, 5> a{3, 1, 4, 1, 5};
+    Sort(a);
+    return a[0] == 1 && a[1] == 1 && a[2] == 3 && a[3] == 4 && a[4] == 5;
+  }());
+
+  CheckSortingNetworks(std::make_index_sequence<kSortingNetworkMaxSize>{});
+  CheckSortingNetwork<kSortingNetworkMaxSize + 1>();
+  CheckSortingNetwork<100>();
+
+  // Floating point, non-arithmetic elements, and an AlignedArray.
+  Array<double, 6> doubles{2.5, -1.0, 0.0, -0.5, 7.25, 2.5};
+  Sort(doubles);
+  Equals(doubles, std::array{-1.0, -0.5, 0.0, 2.5, 2.5, 7.25});
+  Array<std::string, 4> strings{"pear", "apple", "fig", "banana"};
+  Sort(strings);
+  Equals(strings, std::array<std::string, 4>{"apple", "banana", "fig", "pear"});
+  AlignedArray<int16_t, 3> aligned{3, -3, 0};
+  Sort(aligned);
+  Equals(aligned, std::array{-3, 0, 3});
+}
+
+TEST_CASE("SortMany", "[Sort]") {
+  std::mt19937 gen(25);
+  // A few blocks of kSortLanes arrays and a remainder.
+  std::vector<Array<float, 13>> floats(3 * kSortLanes + 5);
+  std::vector<Array<uint64_t, 32>> longs(2 * kSortLanes + 1);
+  std::vector<Array<int, 40>> large(3);
+  const auto check = [&](auto& arrays) {
+    for (auto& array : arrays) {
+      for (auto& element : array.data) {
+        element = static_cast<std::remove_reference_t<decltype(element)>>(gen() % 1000);
+      }
+    }
+    auto expected = arrays;
+    for (auto& array : expected) {
+      std::sort(array.Data(), array.Data() + array.Size());
+    }
+    SortMany(std::span(arrays));
+    for (size_t i = 0; i < arrays.size(); ++i) {
+      REQUIRE(std::equal(arrays[i].Data(), arrays[i].Data() + arrays[i].Size(), expected[i].Data()));
+    }
+  };
+  check(floats);
+  check(longs);
+  check(large);
+}
 
 TEST_CASE("GetSize", "[Array Traits]") {
   SECTION("Not Array") {
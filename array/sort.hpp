@@ -0,0 +1,154 @@
+#pragma once
+#ifndef SORT_HPP
+#define SORT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+#include "array.hpp"
+
+// Arrays of up to this many elements are sorted by a sorting network; longer ones by std::sort.
+inline constexpr size_t kSortingNetworkMaxSize = 32;
+
+// Arrays that SortMany carries through the network side by side, one vector lane each.
+inline constexpr size_t kSortLanes = 16;
+
+namespace array_internal {
+
+struct Comparator {
+  uint8_t low;
+  uint8_t high;
+};
+
+// Calls emit(i, j) for the comparators of Batcher's odd-even merge sort of n elements, in order. The network is built
+// for the next power of two and the comparators that touch an index past n are left out: those indices would hold
+// +infinity, which such a comparator never moves.
+template <class Emit>
+constexpr void OddEvenMergeSortNetwork(size_t n, const Emit& emit) {
+  const auto padded = std::bit_ceil(n);
+  for (size_t p = 1; p < padded; p *= 2) {
+    for (auto k = p; k >= 1; k /= 2) {
+      for (auto j = k % p; j + k < padded; j += 2 * k) {
+        for (size_t i = 0; i < std::min(k, padded - j - k); ++i) {
+          if ((i + j) / (2 * p) == (i + j + k) / (2 * p) && i + j + k < n) {
+            emit(i + j, i + j + k);
+          }
+        }
+      }
+    }
+  }
+}
+
+template <size_t N>
+constexpr size_t SortingNetworkSize() {
+  size_t size = 0;
+  OddEvenMergeSortNetwork(N, [&](size_t, size_t) {
+    ++size;
+  });
+  return size;
+}
+
+template <size_t N>
+constexpr auto MakeSortingNetwork() {
+  std::array<Comparator, SortingNetworkSize<N>()> network{};
+  size_t next = 0;
+  OddEvenMergeSortNetwork(N, [&](size_t low, size_t high) {
+    network[next++] = {static_cast<uint8_t>(low), static_cast<uint8_t>(high)};
+  });
+  return network;
+}
+
+// The comparators of the network for N elements, computed at compile time: 19 for 8 elements, 63 for 16 and 191 for 32,
+// a few more than the best known networks (19, 60 and 185).
+template <size_t N>
+inline constexpr auto kSortingNetwork = MakeSortingNetwork<N>();
+
+// Orders x and y. Arithmetic types take a min and a max, which compile to conditional moves or min/max instructions
+// instead of a branch that mispredicts on random data half of the time.
+template <class T>
+constexpr void CompareExchange(T& x, T& y) {
+  if constexpr (std::is_arithmetic_v<T>) {
+    const auto swap = y < x;
+    const auto low = swap ? y : x;
+    const auto high = swap ? x : y;
+    x = low;
+    y = high;
+  } else if (y < x) {
+    std::swap(x, y);
+  }
+}
+
+// The network unrolled into straight-line code.
+template <size_t N, class T, size_t... kIndices>
+constexpr void ApplySortingNetwork([[maybe_unused]] T* data, std::index_sequence<kIndices...>) {
+  (CompareExchange(data[kSortingNetwork<N>[kIndices].low], data[kSortingNetwork<N>[kIndices].high]), ...);
+}
+
+// Orders rows kLow and kHigh of kSortLanes arrays stored column by column, lanes[i][lane] being element i of array
+// lane. With the rows fixed at compile time the compiler sees that they do not overlap, and the loop becomes one
+// vector min and one vector max.
+template <size_t kLow, size_t kHigh, class T, size_t N>
+inline void CompareExchangeLanes(T (&lanes)[N][kSortLanes]) {
+  for (size_t lane = 0; lane < kSortLanes; ++lane) {
+    const auto x = lanes[kLow][lane];
+    const auto y = lanes[kHigh][lane];
+    const auto swap = y < x;
+    lanes[kLow][lane] = swap ? y : x;
+    lanes[kHigh][lane] = swap ? x : y;
+  }
+}
+
+// The network for N elements on kSortLanes arrays at once, unrolled like ApplySortingNetwork.
+template <class T, size_t N, size_t... kIndices>
+ARRAY_MULTIVERSION void SortLanes(T (&lanes)[N][kSortLanes], std::index_sequence<kIndices...>) {
+  (CompareExchangeLanes<kSortingNetwork<N>[kIndices].low, kSortingNetwork<N>[kIndices].high>(lanes), ...);
+}
+
+}  // namespace array_internal
+
+// Sorts the array in ascending order by operator<. Up to kSortingNetworkMaxSize elements go through a fixed sorting
+// network unrolled at compile time, with branch-free compare-exchanges for arithmetic types; longer arrays use
+// std::sort, an introsort. Not stable.
+template <class T, size_t N>
+constexpr void Sort(Array<T, N>& array) {
+  if constexpr (N <= kSortingNetworkMaxSize) {
+    constexpr auto kNetworkSize = array_internal::kSortingNetwork<N>.size();
+    array_internal::ApplySortingNetwork<N>(array.data, std::make_index_sequence<kNetworkSize>{});
+  } else {
+    std::sort(array.data, array.data + N);
+  }
+}
+
+// Sort of every array. Arithmetic elements in arrays of up to kSortingNetworkMaxSize go kSortLanes arrays at a time
+// through the network in vector registers, after a transposition that puts each array into its own lane.
+template <class T, size_t N>
+void SortMany(std::span<Array<T, N>> arrays) {
+  size_t begin = 0;
+  if constexpr (std::is_arithmetic_v<T> && N <= kSortingNetworkMaxSize) {
+    for (; begin + kSortLanes <= arrays.size(); begin += kSortLanes) {
+      T lanes[N][kSortLanes];
+      for (size_t lane = 0; lane < kSortLanes; ++lane) {
+        for (size_t i = 0; i < N; ++i) {
+          lanes[i][lane] = arrays[begin + lane][i];
+        }
+      }
+      array_internal::SortLanes(lanes, std::make_index_sequence<array_internal::kSortingNetwork<N>.size()>{});
+      for (size_t lane = 0; lane < kSortLanes; ++lane) {
+        for (size_t i = 0; i < N; ++i) {
+          arrays[begin + lane][i] = lanes[i][lane];
+        }
+      }
+    }
+  }
+  for (; begin < arrays.size(); ++begin) {
+    Sort(arrays[begin]);
+  }
+}
+
+#endif
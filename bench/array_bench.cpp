@@ -0,0 +1,128 @@
+// Array::Fill and Array::Swap against the element loops they replace, for uint32_t arrays from L1-resident up to
+// DRAM-sized; the largest one is past kArrayNonTemporalBytes and filled with streaming stores. Per-thread counters in
+// an Array against a PaddedArray. std::sort of small arrays against Sort and SortMany. Run
+// `array_bench --json array.json` to keep the results.
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "array/aligned_array.hpp"
+#include "array/array.hpp"
+#include "array/sort.hpp"
+#include "bench/bench.hpp"
+
+namespace {
+
+template <size_t N>
+void RunSize(bench::Runner& runner) {
+  const auto a = std::make_unique<Array<uint32_t, N>>();
+  const auto b = std::make_unique<Array<uint32_t, N>>();
+  const auto bytes = N * sizeof(uint32_t);
+  const auto suffix = "/" + std::to_string(bytes >> 10) + "KiB";
+  uint32_t value = 0;
+  runner.Run("loop/fill" + suffix, N, bytes, [&] {
+    ++value;
+    for (auto& element : a->data) {
+      element = value;
+    }
+    return a->Back();
+  });
+  runner.Run("Fill" + suffix, N, bytes, [&] {
+    a->Fill(++value);
+    return a->Back();
+  });
+  runner.Run("loop/swap" + suffix, N, 2 * bytes, [&] {
+    for (size_t i = 0; i < N; ++i) {
+      std::swap(a->data[i], b->data[i]);
+    }
+    return a->Back();
+  });
+  runner.Run("Swap" + suffix, N, 2 * bytes, [&] {
+    a->Swap(*b);
+    return a->Back();
+  });
+}
+
+// kCounterThreads threads each bump their own counter with relaxed atomic adds. Packed into one Array the counters
+// share a cache line that every add takes away from the other cores.
+constexpr size_t kCounterThreads = 4;
+
+template <class Counters>
+void RunCounters(bench::Runner& runner, const std::string& name) {
+  constexpr size_t kIncrements = size_t{1} << 20;
+  Counters counters{};
+  runner.Run(name, kCounterThreads * kIncrements, 0, [&] {
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kCounterThreads; ++t) {
+      threads.emplace_back([&counters, t] {
+        for (size_t i = 0; i < kIncrements; ++i) {
+          counters[t].fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+    return counters[0].load();
+  });
+}
+
+// Sorting kNumSmallArrays random arrays of N ints, restored from a copy before each pass.
+template <size_t N>
+void RunSort(bench::Runner& runner, std::mt19937& gen) {
+  constexpr size_t kNumSmallArrays = size_t{1} << 14;
+  std::vector<Array<int, N>> input(kNumSmallArrays);
+  for (auto& array : input) {
+    for (auto& element : array.data) {
+      element = static_cast<int>(gen());
+    }
+  }
+  auto arrays = input;
+  const auto suffix = "/" + std::to_string(N);
+  const auto bytes = kNumSmallArrays * sizeof(Array<int, N>);
+  runner.Run("std::sort" + suffix, kNumSmallArrays, bytes, [&] {
+    arrays = input;
+    for (auto& array : arrays) {
+      std::sort(array.data, array.data + N);
+    }
+    return arrays.back().Back();
+  });
+  runner.Run("Sort" + suffix, kNumSmallArrays, bytes, [&] {
+    arrays = input;
+    for (auto& array : arrays) {
+      Sort(array);
+    }
+    return arrays.back().Back();
+  });
+  runner.Run("SortMany" + suffix, kNumSmallArrays, bytes, [&] {
+    arrays = input;
+    SortMany(std::span(arrays));
+    return arrays.back().Back();
+  });
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bench::Runner runner(bench::ParseOptions(argc, argv));
+  // 32 KiB, 1 MiB and 64 MiB: L1, L2 and DRAM-resident.
+  RunSize<size_t{1} << 13>(runner);
+  RunSize<size_t{1} << 18>(runner);
+  RunSize<size_t{1} << 24>(runner);
+  RunCounters<Array<std::atomic<uint64_t>, kCounterThreads>>(runner, "counters/Array");
+  RunCounters<PaddedArray<std::atomic<uint64_t>, kCounterThreads>>(runner, "counters/PaddedArray");
+  std::mt19937 gen(1);
+  RunSort<8>(runner, gen);
+  RunSort<16>(runner, gen);
+  RunSort<32>(runner, gen);
+  return 0;
+}
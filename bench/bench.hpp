@@ -0,0 +1,206 @@
+#pragma once
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+// Minimal micro-benchmark harness: warmup, calibrated repetitions, median and median absolute deviation (MAD), a text
+// table on stdout and optional JSON output for tracking results over time.
+//
+// Command line options understood by ParseOptions:
+//   --json FILE          write all results to FILE as a JSON array
+//   --repetitions N      measured repetitions per benchmark (default 15)
+//   --warmup N           unmeasured repetitions per benchmark (default 3)
+//   --filter SUBSTRING   run only benchmarks whose name contains SUBSTRING
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace bench {
+
+struct Options {
+  size_t warmup = 3;
+  size_t repetitions = 15;
+  std::string json_path;
+  std::string filter;
+};
+
+struct Result {
+  std::string name;
+  size_t elements = 0;    // processed by one call of the benchmark body
+  size_t bytes = 0;       // read by one call of the benchmark body
+  size_t iterations = 0;  // body calls per repetition
+  double median_ns = 0;   // per body call
+  double mad_ns = 0;
+
+  double NsPerElement() const {
+    return elements == 0 ? 0 : median_ns / static_cast<double>(elements);
+  }
+
+  double GigabytesPerSecond() const {
+    return median_ns == 0 ? 0 : static_cast<double>(bytes) / median_ns;
+  }
+};
+
+// Keeps the compiler from optimizing away the computation of value.
+template <class T>
+inline void DoNotOptimize(const T& value) {
+#if defined(__GNUC__)
+  asm volatile("" : : "r,m"(value) : "memory");
+#else
+  static const T* volatile sink;
+  sink = &value;
+#endif
+}
+
+inline Options ParseOptions(int argc, char** argv) {
+  Options options;
+  const auto usage = [&] {
+    std::cerr << "usage: " << argv[0] << " [--json FILE] [--repetitions N] [--warmup N] [--filter SUBSTRING]\n";
+    std::exit(2);
+  };
+  const auto parse_count = [&](const std::string& value) {
+    size_t count = 0;
+    const auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), count);
+    if (error != std::errc{} || end != value.data() + value.size()) {
+      std::cerr << argv[0] << ": invalid count: " << value << '\n';
+      usage();
+    }
+    return count;
+  };
+  for (int i = 1; i < argc; ++i) {
+    const std::string_view arg = argv[i];
+    if (i + 1 == argc) {
+      usage();
+    }
+    const std::string value = argv[++i];
+    if (arg == "--json") {
+      options.json_path = value;
+    } else if (arg == "--repetitions") {
+      options.repetitions = std::max<size_t>(parse_count(value), 1);
+    } else if (arg == "--warmup") {
+      options.warmup = parse_count(value);
+    } else if (arg == "--filter") {
+      options.filter = value;
+    } else {
+      usage();
+    }
+  }
+  return options;
+}
+
+class Runner {
+ public:
+  explicit Runner(Options options) : options_(std::move(options)) {
+    std::printf("%-40s %12s %12s %10s %12s %10s\n", "benchmark", "elements", "median ns", "MAD %", "ns/element",
+                "GB/s");
+  }
+
+  Runner(const Runner&) = delete;
+  Runner& operator=(const Runner&) = delete;
+
+  ~Runner() {
+    if (!options_.json_path.empty()) {
+      WriteJson();
+    }
+  }
+
+  // Measures body(), which processes `elements` elements stored in `bytes` bytes. Each repetition calls the body
+  // enough times to run for at least kMinRepetitionTime, so that even L1-sized inputs are above the timer resolution.
+  template <class Body>
+  void Run(const std::string& name, size_t elements, size_t bytes, Body body) {
+    if (name.find(options_.filter) == std::string::npos) {
+      return;
+    }
+    const auto iterations = Calibrate(body);
+    for (size_t i = 0; i < options_.warmup; ++i) {
+      Repeat(body, iterations);
+    }
+    std::vector<double> samples(options_.repetitions);
+    for (auto& sample : samples) {
+      sample = Repeat(body, iterations) / static_cast<double>(iterations);
+    }
+    const auto median = Median(samples);
+    for (auto& sample : samples) {
+      sample = sample > median ? sample - median : median - sample;
+    }
+    Result result{name, elements, bytes, iterations, median, Median(samples)};
+    std::printf("%-40s %12zu %12.1f %10.2f %12.4f %10.2f\n", name.c_str(), elements, result.median_ns,
+                median == 0 ? 0 : 100 * result.mad_ns / median, result.NsPerElement(), result.GigabytesPerSecond());
+    std::fflush(stdout);
+    results_.push_back(std::move(result));
+  }
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  static constexpr std::chrono::nanoseconds kMinRepetitionTime = std::chrono::milliseconds(2);
+
+  template <class Body>
+  static double Repeat(Body& body, size_t iterations) {
+    const auto start = Clock::now();
+    for (size_t i = 0; i < iterations; ++i) {
+      DoNotOptimize(body());
+    }
+    return static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count());
+  }
+
+  template <class Body>
+  static size_t Calibrate(Body& body) {
+    size_t iterations = 1;
+    while (Repeat(body, iterations) < static_cast<double>(kMinRepetitionTime.count())) {
+      iterations *= 2;
+    }
+    return iterations;
+  }
+
+  static double Median(std::vector<double> values) {
+    const auto middle = values.begin() + static_cast<std::ptrdiff_t>(values.size() / 2);
+    std::nth_element(values.begin(), middle, values.end());
+    return *middle;
+  }
+
+  static std::string Escape(const std::string& text) {
+    std::string escaped;
+    for (const auto symbol : text) {
+      if (symbol == '"' || symbol == '\\') {
+        escaped += '\\';
+      }
+      escaped += symbol;
+    }
+    return escaped;
+  }
+
+  void WriteJson() const {
+    std::ofstream out(options_.json_path);
+    out << "[\n";
+    for (size_t i = 0; i < results_.size(); ++i) {
+      const auto& result = results_[i];
+      out << "  {\"name\": \"" << Escape(result.name) << "\", \"elements\": " << result.elements
+          << ", \"bytes\": " << result.bytes << ", \"iterations\": " << result.iterations
+          << ", \"repetitions\": " << options_.repetitions << ", \"median_ns\": " << result.median_ns
+          << ", \"mad_ns\": " << result.mad_ns << ", \"ns_per_element\": " << result.NsPerElement()
+          << ", \"gb_per_s\": " << result.GigabytesPerSecond() << "}" << (i + 1 < results_.size() ? ",\n" : "\n");
+    }
+    out << "]\n";
+    if (!out) {
+      std::cerr << "failed to write " << options_.json_path << '\n';
+    }
+  }
+
+  Options options_;
+  std::vector<Result> results_;
+};
+
+}  // namespace bench
+
+#endif
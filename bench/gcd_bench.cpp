@@ -0,0 +1,296 @@
+// Gcd (binary algorithm) against the modulo-based Euclid baseline and the batched GcdMany on random operands and on
+// consecutive Fibonacci numbers, the worst case for Euclid; the small-operand table against the binary algorithm;
+// AllPairsGcd against a loop over all pairs; Lehmer's Gcd of 256..4096-bit BigUints against Euclid; BatchGcd against
+// Gcd over all pairs of moduli; Factorize of semiprimes; modular exponentiation by division against ModRing.
+// Run `gcd_bench --json gcd.json` to keep the results.
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "gcd/all_pairs_gcd.hpp"
+#include "gcd/batch_gcd.hpp"
+#include "gcd/big_uint.hpp"
+#include "gcd/factorize.hpp"
+#include "gcd/gcd.hpp"
+#include "gcd/mod_int.hpp"
+
+namespace {
+
+constexpr size_t kNumPairs = 4096;
+
+template <class T>
+T EuclidGcd(T x, T y) {
+  while (y != 0) {
+    x = static_cast<T>(x % y);
+    std::swap(x, y);
+  }
+  return x;
+}
+
+template <class T>
+struct Pairs {
+  std::vector<T> x;
+  std::vector<T> y;
+};
+
+template <class T>
+Pairs<T> RandomPairs(std::mt19937_64& gen) {
+  std::uniform_int_distribution<T> dist(1);
+  Pairs<T> pairs;
+  for (size_t i = 0; i < kNumPairs; ++i) {
+    pairs.x.push_back(dist(gen));
+    pairs.y.push_back(dist(gen));
+  }
+  return pairs;
+}
+
+// Consecutive Fibonacci numbers cycling through the whole range of T.
+template <class T>
+Pairs<T> FibonacciPairs() {
+  std::vector<T> fibonacci{1, 2};
+  while (fibonacci.back() <= std::numeric_limits<T>::max() - fibonacci[fibonacci.size() - 2]) {
+    fibonacci.push_back(fibonacci.back() + fibonacci[fibonacci.size() - 2]);
+  }
+  Pairs<T> pairs;
+  for (size_t i = 0; i < kNumPairs; ++i) {
+    const auto index = fibonacci.size() / 2 + i % (fibonacci.size() / 2);
+    pairs.x.push_back(fibonacci[index]);
+    pairs.y.push_back(fibonacci[index - 1]);
+  }
+  return pairs;
+}
+
+template <class T, class GcdFunction>
+void RunPairs(bench::Runner& runner, const std::string& name, const Pairs<T>& pairs, GcdFunction gcd) {
+  runner.Run(name, kNumPairs, 2 * kNumPairs * sizeof(T), [&] {
+    T checksum = 0;
+    for (size_t i = 0; i < kNumPairs; ++i) {
+      checksum ^= gcd(pairs.x[i], pairs.y[i]);
+    }
+    return checksum;
+  });
+}
+
+template <class T>
+void RunMany(bench::Runner& runner, const std::string& name, const Pairs<T>& pairs) {
+  std::vector<T> out(kNumPairs);
+  runner.Run(name, kNumPairs, 2 * kNumPairs * sizeof(T), [&] {
+    GcdMany<T>(pairs.x, pairs.y, out);
+    return out.back();
+  });
+}
+
+template <class T>
+void RunType(bench::Runner& runner, const std::string& type_name, std::mt19937_64& gen) {
+  const auto random = RandomPairs<T>(gen);
+  const auto fibonacci = FibonacciPairs<T>();
+  RunPairs(runner, "Euclid/random/" + type_name, random, EuclidGcd<T>);
+  RunPairs(runner, "Gcd/random/" + type_name, random, Gcd<T>);
+  RunMany(runner, "GcdMany/random/" + type_name, random);
+  RunPairs(runner, "Euclid/fibonacci/" + type_name, fibonacci, EuclidGcd<T>);
+  RunPairs(runner, "Gcd/fibonacci/" + type_name, fibonacci, Gcd<T>);
+  RunMany(runner, "GcdMany/fibonacci/" + type_name, fibonacci);
+}
+
+// Operands below the small-operand table, all of them or about half of them, with Gcd against the plain binary
+// algorithm it falls back to.
+void RunSmall(bench::Runner& runner, std::mt19937_64& gen) {
+  const auto table = "/table-" + std::to_string(gcd_internal::kGcdSmallTable.size()) + "B";
+  std::uniform_int_distribution<uint32_t> small(0, std::max<uint32_t>(kGcdSmallTableSize, 1) - 1);
+  for (const auto* mix : {"small", "mixed"}) {
+    Pairs<uint32_t> pairs;
+    for (size_t i = 0; i < kNumPairs; ++i) {
+      const auto wide = mix == std::string("mixed") && gen() % 2 == 0;
+      pairs.x.push_back(wide ? static_cast<uint32_t>(gen()) : small(gen));
+      pairs.y.push_back(wide ? static_cast<uint32_t>(gen()) : small(gen));
+    }
+    RunPairs(runner, std::string("BinaryGcd/") + mix + "/uint32", pairs, gcd_internal::BinaryGcd<uint32_t>);
+    RunPairs(runner, std::string("Gcd/") + mix + table + "/uint32", pairs, Gcd<uint32_t>);
+  }
+}
+
+// The GCD matrix of 1024 random values, from Gcd on every pair and from the tiles of AllPairsGcd.
+void RunAllPairs(bench::Runner& runner, std::mt19937_64& gen) {
+  constexpr size_t kNumValues = 1024;
+  std::vector<uint32_t> values(kNumValues);
+  for (auto& value : values) {
+    value = static_cast<uint32_t>(gen());
+  }
+  std::vector<uint32_t> matrix(kNumValues * kNumValues);
+  const auto suffix = "/" + std::to_string(kNumValues) + "/uint32";
+  runner.Run("Gcd/all-pairs" + suffix, kNumValues * kNumValues, kNumValues * sizeof(uint32_t), [&] {
+    for (size_t i = 0; i < kNumValues; ++i) {
+      for (size_t j = 0; j < kNumValues; ++j) {
+        matrix[i * kNumValues + j] = Gcd(values[i], values[j]);
+      }
+    }
+    return matrix.back();
+  });
+  runner.Run("AllPairsGcd" + suffix, kNumValues * kNumValues, kNumValues * sizeof(uint32_t), [&] {
+    return AllPairsGcd<uint32_t>(values).back();
+  });
+}
+
+BigUint RandomBigUint(std::mt19937_64& gen, size_t bits) {
+  std::vector<uint64_t> limbs(bits / 64);
+  for (auto& limb : limbs) {
+    limb = gen();
+  }
+  return BigUint(limbs);
+}
+
+BigUint EuclidBigGcd(BigUint x, BigUint y) {
+  while (!y.IsZero()) {
+    x %= y;
+    std::swap(x, y);
+  }
+  return x;
+}
+
+void RunBigUint(bench::Runner& runner, std::mt19937_64& gen) {
+  constexpr size_t kNumBigPairs = 16;
+  for (const size_t bits : {256, 1024, 4096}) {
+    std::vector<BigUint> x;
+    std::vector<BigUint> y;
+    for (size_t i = 0; i < kNumBigPairs; ++i) {
+      x.push_back(RandomBigUint(gen, bits));
+      y.push_back(RandomBigUint(gen, bits));
+    }
+    const auto run = [&](const std::string& name, auto gcd) {
+      runner.Run(name + "/" + std::to_string(bits), kNumBigPairs, 2 * kNumBigPairs * bits / 8, [&] {
+        uint64_t checksum = 0;
+        for (size_t i = 0; i < kNumBigPairs; ++i) {
+          checksum ^= gcd(x[i], y[i]).Limb(0);
+        }
+        return checksum;
+      });
+    };
+    run("Euclid/BigUint", EuclidBigGcd);
+    run("Gcd/BigUint", [](const BigUint& a, const BigUint& b) {
+      return Gcd(a, b);
+    });
+  }
+}
+
+// Moduli sharing a factor among n random ones, found by Gcd over all pairs and by BatchGcd.
+void RunBatchGcd(bench::Runner& runner, std::mt19937_64& gen) {
+  for (const size_t size : {1024, 16384}) {
+    std::vector<uint64_t> moduli(size);
+    for (auto& modulus : moduli) {
+      modulus = ((gen() >> 32) | 1) * ((gen() >> 32) | 1);
+    }
+    const auto suffix = "/" + std::to_string(size);
+    if (size <= 1024) {
+      runner.Run("Gcd/all-pairs" + suffix, size, size * sizeof(uint64_t), [&] {
+        size_t shared = 0;
+        for (size_t i = 0; i < size; ++i) {
+          for (size_t j = 0; j < size; ++j) {
+            shared += static_cast<size_t>(i != j && Gcd(moduli[i], moduli[j]) != 1);
+          }
+        }
+        return shared;
+      });
+    }
+    runner.Run("BatchGcd" + suffix, size, size * sizeof(uint64_t), [&] {
+      return BatchGcd(moduli).back();
+    });
+  }
+}
+
+// Factorize on products of two random 32-bit primes, the hard case for Pollard's rho, one value at a time and through
+// FactorizeMany.
+void RunFactorize(bench::Runner& runner, std::mt19937_64& gen) {
+  constexpr size_t kNumValues = 64;
+  const auto random_prime = [&] {
+    auto candidate = static_cast<uint32_t>(gen()) | 0x80000001u;
+    while (!IsPrime(candidate)) {
+      candidate += 2;
+    }
+    return uint64_t{candidate};
+  };
+  std::vector<uint64_t> values;
+  for (size_t i = 0; i < kNumValues; ++i) {
+    values.push_back(random_prime() * random_prime());
+  }
+  runner.Run("Factorize/semiprime/uint64", kNumValues, kNumValues * sizeof(uint64_t), [&] {
+    uint64_t checksum = 0;
+    for (const auto value : values) {
+      checksum ^= Factorize(value).front();
+    }
+    return checksum;
+  });
+  runner.Run("FactorizeMany/semiprime/uint64", kNumValues, kNumValues * sizeof(uint64_t), [&] {
+    return FactorizeMany<uint64_t>(values).back().front();
+  });
+}
+
+// Modular exponentiation of random bases to a 64-bit exponent: square-and-multiply with a division per product, the
+// ModRing reductions one base at a time, and PowMany over the whole batch.
+void RunModPow(bench::Runner& runner, std::mt19937_64& gen) {
+  constexpr size_t kNumBases = 1024;
+  const auto exponent = gen() | uint64_t{1} << 63;
+  const std::pair<const char*, uint64_t> moduli[] = {
+      {"odd32", 998244353}, {"even32", 4294967294u}, {"odd64", (uint64_t{1} << 61) - 1}};
+  for (const auto& [modulus_name, modulus] : moduli) {
+    std::vector<uint64_t> bases(kNumBases);
+    for (auto& base : bases) {
+      base = gen() % modulus;
+    }
+    const ModRing ring(modulus);
+    const auto suffix = std::string("/") + modulus_name;
+    runner.Run("PowMod/division" + suffix, kNumBases, kNumBases * sizeof(uint64_t), [&] {
+      uint64_t checksum = 0;
+      for (auto base : bases) {
+        uint64_t result = 1;
+        for (auto rest = exponent; rest != 0; rest >>= 1) {
+          uint64_t high = 0;
+          uint64_t low = 0;
+          if ((rest & 1) != 0) {
+            low = gcd_internal::MulWide(result, base, high);
+            gcd_internal::DivWide(high, low, modulus, result);
+          }
+          low = gcd_internal::MulWide(base, base, high);
+          gcd_internal::DivWide(high, low, modulus, base);
+        }
+        checksum ^= result;
+      }
+      return checksum;
+    });
+    runner.Run("PowMod/ModRing" + suffix, kNumBases, kNumBases * sizeof(uint64_t), [&] {
+      uint64_t checksum = 0;
+      for (const auto base : bases) {
+        checksum ^= ring.From(ring.Pow(ring.To(base), exponent));
+      }
+      return checksum;
+    });
+    std::vector<uint64_t> out(kNumBases);
+    runner.Run("PowMany" + suffix, kNumBases, kNumBases * sizeof(uint64_t), [&] {
+      ring.PowMany(bases, exponent, out);
+      return out.back();
+    });
+  }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bench::Runner runner(bench::ParseOptions(argc, argv));
+  std::mt19937_64 gen(1);
+  RunType<uint32_t>(runner, "uint32", gen);
+  RunType<uint64_t>(runner, "uint64", gen);
+  RunSmall(runner, gen);
+  RunAllPairs(runner, gen);
+  RunBigUint(runner, gen);
+  RunBatchGcd(runner, gen);
+  RunFactorize(runner, gen);
+  RunModPow(runner, gen);
+  return 0;
+}
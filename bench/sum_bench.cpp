@@ -0,0 +1,56 @@
+// Throughput of the scalar loop over Sum, the vectorized SumRange and the multithreaded SumParallel for inputs from
+// L1-resident up to DRAM-sized. Run `sum_bench --json sum.json` to keep the results.
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "bench/bench.hpp"
+#include "sum/sum.h"
+
+namespace {
+
+// 4 KiB .. 256 MiB of ints: L1, L2, L3 and DRAM-resident working sets.
+constexpr size_t kSizes[] = {size_t{1} << 10, size_t{1} << 13, size_t{1} << 16, size_t{1} << 20, size_t{1} << 22,
+                             size_t{1} << 26};
+
+// The loop the bulk kernels replace: one out-of-line Sum call per element.
+int64_t ScalarLoop(std::span<const int> values) {
+  int64_t sum = 0;
+  for (const auto value : values) {
+    sum += Sum(value, 0);
+  }
+  return sum;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  bench::Runner runner(bench::ParseOptions(argc, argv));
+  std::mt19937 gen(1);
+  std::uniform_int_distribution<int> dist;
+  std::vector<int> values(kSizes[std::size(kSizes) - 1]);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+
+  for (const auto size : kSizes) {
+    const auto input = std::span<const int>(values).first(size);
+    const auto bytes = size * sizeof(int);
+    const auto suffix = "/" + std::to_string(size);
+    runner.Run("scalar" + suffix, size, bytes, [&] {
+      return ScalarLoop(input);
+    });
+    runner.Run("SumRange" + suffix, size, bytes, [&] {
+      return SumRange(input);
+    });
+    runner.Run("SumParallel" + suffix, size, bytes, [&] {
+      return SumParallel(input);
+    });
+  }
+  return 0;
+}
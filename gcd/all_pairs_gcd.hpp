@@ -0,0 +1,95 @@
+#pragma once
+#ifndef ALL_PAIRS_GCD_HPP
+#define ALL_PAIRS_GCD_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <span>
+#include <utility>
+#include <vector>
+
+#include "gcd.hpp"
+#include "parallel/parallel.hpp"
+
+// Rows and columns of an AllPairsGcd tile: three 64 x 64 buffers of 64-bit values take 96 KiB, which stays in L2.
+inline constexpr size_t kAllPairsGcdTile = 64;
+
+// The GCDs of values[row_begin, row_begin + num_rows) against values[column_begin, column_begin + num_columns), row by
+// row: gcds[i * num_columns + j] == Gcd(values[row_begin + i], values[column_begin + j]).
+template <class T>
+struct AllPairsGcdTile {
+  size_t row_begin = 0;
+  size_t column_begin = 0;
+  size_t num_rows = 0;
+  size_t num_columns = 0;
+  std::span<const T> gcds;
+};
+
+// Calls callback(tile) with an AllPairsGcdTile for every tile on or above the diagonal of the matrix of GCDs of all
+// pairs of values, so each pair (i, j) with i < j is reported once, and the tiles on the diagonal also hold the pairs
+// with i >= j. Each tile is computed by one GcdMany call and the tiles are spread over num_threads threads (0 means one
+// per hardware thread); the callback gets them as they are done, in no particular order and never two at a time, and
+// the tile's buffer is reused after it returns. Memory stays at a few tiles per thread however many values there are.
+template <class T, class Callback>
+void ForEachAllPairsGcdTile(std::span<const T> values, const Callback& callback, size_t num_threads = 0) {
+  const auto num_blocks = (values.size() + kAllPairsGcdTile - 1) / kAllPairsGcdTile;
+  std::vector<std::pair<size_t, size_t>> tiles;
+  for (size_t row = 0; row < num_blocks; ++row) {
+    for (size_t column = row; column < num_blocks; ++column) {
+      tiles.emplace_back(row * kAllPairsGcdTile, column * kAllPairsGcdTile);
+    }
+  }
+  num_threads = parallel_internal::ResolveThreadCount(num_threads, tiles.size());
+  std::atomic<size_t> next_tile = 0;
+  std::mutex callback_mutex;
+  // One task per thread, each with its own buffers that it fills again for every tile it takes.
+  parallel_internal::ParallelFor(num_threads, num_threads, [&](size_t) {
+    std::vector<T> x(kAllPairsGcdTile * kAllPairsGcdTile);
+    std::vector<T> y(kAllPairsGcdTile * kAllPairsGcdTile);
+    std::vector<T> gcds(kAllPairsGcdTile * kAllPairsGcdTile);
+    for (auto index = next_tile.fetch_add(1, std::memory_order_relaxed); index < tiles.size();
+         index = next_tile.fetch_add(1, std::memory_order_relaxed)) {
+      AllPairsGcdTile<T> tile;
+      std::tie(tile.row_begin, tile.column_begin) = tiles[index];
+      tile.num_rows = std::min(kAllPairsGcdTile, values.size() - tile.row_begin);
+      tile.num_columns = std::min(kAllPairsGcdTile, values.size() - tile.column_begin);
+      // The pairs of the tile laid out side by side, so that one GcdMany call keeps all of its lanes busy.
+      const auto size = tile.num_rows * tile.num_columns;
+      for (size_t i = 0; i < tile.num_rows; ++i) {
+        const auto row = x.begin() + i * tile.num_columns;
+        std::fill(row, row + tile.num_columns, values[tile.row_begin + i]);
+        std::copy_n(values.begin() + tile.column_begin, tile.num_columns, y.begin() + i * tile.num_columns);
+      }
+      const auto out = std::span<T>(gcds).first(size);
+      GcdMany<T>(std::span<const T>(x).first(size), std::span<const T>(y).first(size), out);
+      tile.gcds = out;
+      const std::lock_guard lock(callback_mutex);
+      callback(tile);
+    }
+  });
+}
+
+// The full values.size() x values.size() matrix of GCDs, row-major, from the tiles of ForEachAllPairsGcdTile and their
+// mirror images.
+template <class T>
+std::vector<T> AllPairsGcd(std::span<const T> values, size_t num_threads = 0) {
+  const auto size = values.size();
+  std::vector<T> matrix(size * size);
+  ForEachAllPairsGcdTile<T>(
+      values,
+      [&](const AllPairsGcdTile<T>& tile) {
+        for (size_t i = 0; i < tile.num_rows; ++i) {
+          for (size_t j = 0; j < tile.num_columns; ++j) {
+            const auto gcd = tile.gcds[i * tile.num_columns + j];
+            matrix[(tile.row_begin + i) * size + tile.column_begin + j] = gcd;
+            matrix[(tile.column_begin + j) * size + tile.row_begin + i] = gcd;
+          }
+        }
+      },
+      num_threads);
+  return matrix;
+}
+
+#endif
@@ -0,0 +1,153 @@
+#pragma once
+#ifndef BATCH_GCD_HPP
+#define BATCH_GCD_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "big_uint.hpp"
+#include "parallel/parallel.hpp"
+
+class BatchGcdZeroValue : public std::invalid_argument {
+ public:
+  BatchGcdZeroValue() : std::invalid_argument("BatchGcdZeroValue") {
+  }
+};
+
+// The remainder tree is split level by level until it has this many subtrees per thread, which then descend
+// independently.
+inline constexpr size_t kBatchGcdSubtreesPerThread = 8;
+
+namespace gcd_internal {
+
+// Runs task(i) for i in [0, size) on num_threads threads, handing out consecutive indices a few chunks per thread.
+template <class Task>
+void ParallelForChunks(size_t size, size_t num_threads, const Task& task) {
+  const auto chunk = std::max<size_t>(1, size / (kBatchGcdSubtreesPerThread * num_threads));
+  parallel_internal::ParallelFor((size + chunk - 1) / chunk, num_threads, [&](size_t index) {
+    for (auto i = index * chunk; i < std::min(size, (index + 1) * chunk); ++i) {
+      task(i);
+    }
+  });
+}
+
+// Level 0 holds the values, every node above is the product of the two below it (or a copy of an unpaired last one),
+// and the single node on top is the product of all values.
+inline std::vector<std::vector<BigUint>> ProductTree(std::span<const BigUint> values, size_t num_threads) {
+  std::vector<std::vector<BigUint>> levels{std::vector<BigUint>(values.begin(), values.end())};
+  while (levels.back().size() > 1) {
+    const auto& below = levels.back();
+    std::vector<BigUint> level((below.size() + 1) / 2);
+    ParallelForChunks(level.size(), num_threads, [&](size_t i) {
+      level[i] = 2 * i + 1 < below.size() ? below[2 * i] * below[2 * i + 1] : below[2 * i];
+    });
+    levels.push_back(std::move(level));
+  }
+  return levels;
+}
+
+// The squares of the product tree nodes, the moduli of the remainder tree, level by level up to the one below the top.
+inline std::vector<std::vector<BigUint>> SquareTree(const std::vector<std::vector<BigUint>>& levels,
+                                                    size_t num_threads) {
+  std::vector<std::vector<BigUint>> squares(levels.size() - 1);
+  for (size_t level = 0; level < squares.size(); ++level) {
+    const auto& nodes = levels[level];
+    squares[level].resize(nodes.size());
+    ParallelForChunks(nodes.size(), num_threads, [&](size_t i) {
+      squares[level][i] = nodes[i] * nodes[i];
+    });
+  }
+  return squares;
+}
+
+// Descends from node index of the given level, where rest = P mod node^2 for the product P of all values, and calls
+// emit(i, Gcd(x, P / x)) for each value x = values[i] below. At a leaf rest = P mod x^2, so rest / x = (P / x) mod x.
+template <class Emit>
+void DescendRemainderTree(const std::vector<std::vector<BigUint>>& levels,
+                          const std::vector<std::vector<BigUint>>& squares, size_t level, size_t index,
+                          const BigUint& rest, const Emit& emit) {
+  if (level == 0) {
+    const auto& value = levels[0][index];
+    emit(index, Gcd(rest / value, value));
+    return;
+  }
+  const auto& below = squares[level - 1];
+  for (auto child = 2 * index; child < std::min(below.size(), 2 * index + 2); ++child) {
+    DescendRemainderTree(levels, squares, level - 1, child, rest % below[child], emit);
+  }
+}
+
+}  // namespace gcd_internal
+
+// Bernstein's batch GCD: calls callback(i, g) with g = Gcd(values[i], product of all other values) for every i, which
+// exposes the values sharing a factor with any other one (a g other than 1) without comparing pairs. A product tree
+// and a remainder tree over it take a few multiplications and divisions of numbers as long as the whole input per
+// level. Each level of the product tree and the top of the remainder tree are split over num_threads threads (0 means
+// one per hardware thread); below that whole subtrees run in parallel and report their leaves as soon as they are
+// reached. Calls to callback come in no particular order but never overlap. Throws BatchGcdZeroValue if a value is 0.
+template <class Callback>
+void ForEachBatchGcd(std::span<const BigUint> values, const Callback& callback, size_t num_threads = 0) {
+  if (values.empty()) {
+    return;
+  }
+  if (std::ranges::any_of(values, [](const BigUint& value) {
+        return value.IsZero();
+      })) {
+    throw BatchGcdZeroValue{};
+  }
+  num_threads = parallel_internal::ResolveThreadCount(num_threads, values.size());
+  const auto levels = gcd_internal::ProductTree(values, num_threads);
+  const auto squares = gcd_internal::SquareTree(levels, num_threads);
+  std::mutex callback_mutex;
+  const auto emit = [&](size_t index, const BigUint& gcd) {
+    const std::lock_guard lock(callback_mutex);
+    callback(index, gcd);
+  };
+
+  auto level = levels.size() - 1;
+  std::vector<BigUint> rests{levels.back()[0]};
+  while (level > 0 && rests.size() < kBatchGcdSubtreesPerThread * num_threads) {
+    const auto& below = squares[level - 1];
+    std::vector<BigUint> next(below.size());
+    gcd_internal::ParallelForChunks(below.size(), num_threads, [&](size_t i) {
+      next[i] = rests[i / 2] % below[i];
+    });
+    rests = std::move(next);
+    --level;
+  }
+  parallel_internal::ParallelFor(rests.size(), num_threads, [&](size_t i) {
+    gcd_internal::DescendRemainderTree(levels, squares, level, i, rests[i], emit);
+  });
+}
+
+// The results of ForEachBatchGcd in the order of values.
+inline std::vector<BigUint> BatchGcd(std::span<const BigUint> values, size_t num_threads = 0) {
+  std::vector<BigUint> gcds(values.size());
+  ForEachBatchGcd(
+      values,
+      [&](size_t index, const BigUint& gcd) {
+        gcds[index] = gcd;
+      },
+      num_threads);
+  return gcds;
+}
+
+inline std::vector<uint64_t> BatchGcd(std::span<const uint64_t> values, size_t num_threads = 0) {
+  const std::vector<BigUint> big_values(values.begin(), values.end());
+  std::vector<uint64_t> gcds(values.size());
+  ForEachBatchGcd(
+      std::span<const BigUint>(big_values),
+      [&](size_t index, const BigUint& gcd) {
+        gcds[index] = gcd.Limb(0);
+      },
+      num_threads);
+  return gcds;
+}
+
+#endif
@@ -0,0 +1,802 @@
+#pragma once
+#ifndef BIG_UINT_HPP
+#define BIG_UINT_HPP
+
+#include <algorithm>
+#include <bit>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <memory>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "gcd.hpp"
+
+class BigUintDivisionByZero : public std::runtime_error {
+ public:
+  BigUintDivisionByZero() : std::runtime_error("BigUintDivisionByZero") {
+  }
+};
+
+class BigUintUnderflow : public std::runtime_error {
+ public:
+  BigUintUnderflow() : std::runtime_error("BigUintUnderflow") {
+  }
+};
+
+class BigUintInvalidString : public std::invalid_argument {
+ public:
+  BigUintInvalidString() : std::invalid_argument("BigUintInvalidString") {
+  }
+};
+
+namespace gcd_internal {
+
+// Portable versions of the double-limb operations below, for compilers without a 128-bit integer.
+constexpr uint64_t MulWidePortable(uint64_t x, uint64_t y, uint64_t& high) {
+  constexpr uint64_t kLowHalf = 0xffffffff;
+  const auto low_low = (x & kLowHalf) * (y & kLowHalf);
+  const auto low_high = (x & kLowHalf) * (y >> 32);
+  const auto high_low = (x >> 32) * (y & kLowHalf);
+  const auto middle = (low_low >> 32) + (low_high & kLowHalf) + (high_low & kLowHalf);
+  high = (x >> 32) * (y >> 32) + (low_high >> 32) + (high_low >> 32) + (middle >> 32);
+  return middle << 32 | (low_low & kLowHalf);
+}
+
+// DivWide by schoolbook division in 32-bit digits (Hacker's Delight, divlu).
+inline uint64_t DivWidePortable(uint64_t high, uint64_t low, uint64_t divisor, uint64_t& remainder) {
+  constexpr uint64_t kBase = uint64_t{1} << 32;
+  const auto shift = std::countl_zero(divisor);
+  divisor <<= shift;
+  const auto divisor_high = divisor >> 32;
+  const auto divisor_low = divisor & (kBase - 1);
+  const auto numerator = shift == 0 ? high : high << shift | low >> (64 - shift);
+  const auto low_shifted = low << shift;
+  const auto low_high = low_shifted >> 32;
+  const auto low_low = low_shifted & (kBase - 1);
+
+  // One 32-bit digit of the quotient of (top, next) by the divisor, with the estimate from the high divisor digit.
+  const auto digit = [&](uint64_t top, uint64_t next) {
+    auto q = top / divisor_high;
+    auto rest = top - q * divisor_high;
+    while (q >= kBase || q * divisor_low > (rest << 32 | next)) {
+      --q;
+      rest += divisor_high;
+      if (rest >= kBase) {
+        break;
+      }
+    }
+    return q;
+  };
+  const auto quotient_high = digit(numerator, low_high);
+  const auto middle = (numerator << 32) + low_high - quotient_high * divisor;
+  const auto quotient_low = digit(middle, low_low);
+  remainder = ((middle << 32) + low_low - quotient_low * divisor) >> shift;
+  return quotient_high << 32 | quotient_low;
+}
+
+// Low half of the 128-bit product x * y, the high half goes to high.
+constexpr uint64_t MulWide(uint64_t x, uint64_t y, uint64_t& high) {
+#ifdef __SIZEOF_INT128__
+  const auto product = Uint128{x} * y;
+  high = static_cast<uint64_t>(product >> 64);
+  return static_cast<uint64_t>(product);
+#else
+  return MulWidePortable(x, y, high);
+#endif
+}
+
+// (high * 2^64 + low) / divisor for high < divisor, the remainder goes to remainder.
+inline uint64_t DivWide(uint64_t high, uint64_t low, uint64_t divisor, uint64_t& remainder) {
+#if defined(__GNUC__) && defined(__x86_64__)
+  // A 128-bit division would be a library call that cannot know the quotient fits into 64 bits.
+  uint64_t quotient = 0;
+  asm("divq %4" : "=a"(quotient), "=d"(remainder) : "a"(low), "d"(high), "rm"(divisor));
+  return quotient;
+#elif defined(__SIZEOF_INT128__)
+  const auto dividend = Uint128{high} << 64 | low;
+  remainder = static_cast<uint64_t>(dividend % divisor);
+  return static_cast<uint64_t>(dividend / divisor);
+#else
+  return DivWidePortable(high, low, divisor, remainder);
+#endif
+}
+
+// x += y for x.size() >= y.size(), returns the carry out of x.
+inline uint64_t AddLimbs(std::span<uint64_t> x, std::span<const uint64_t> y) {
+  uint64_t carry = 0;
+  size_t i = 0;
+  for (; i < y.size(); ++i) {
+    const auto sum = x[i] + y[i];
+    const auto next_carry = static_cast<uint64_t>(sum < x[i]);
+    x[i] = sum + carry;
+    carry = next_carry | static_cast<uint64_t>(x[i] < carry);
+  }
+  for (; carry != 0 && i < x.size(); ++i) {
+    carry = static_cast<uint64_t>(++x[i] == 0);
+  }
+  return carry;
+}
+
+// x -= y for x.size() >= y.size(), returns the borrow out of x.
+inline uint64_t SubLimbs(std::span<uint64_t> x, std::span<const uint64_t> y) {
+  uint64_t borrow = 0;
+  size_t i = 0;
+  for (; i < y.size(); ++i) {
+    const auto difference = x[i] - y[i];
+    const auto next_borrow = static_cast<uint64_t>(x[i] < y[i]);
+    x[i] = difference - borrow;
+    borrow = next_borrow | static_cast<uint64_t>(difference < borrow);
+  }
+  for (; borrow != 0 && i < x.size(); ++i) {
+    borrow = static_cast<uint64_t>(x[i]-- == 0);
+  }
+  return borrow;
+}
+
+// out[0, x.size()) += x * factor, returns the limb carried out.
+inline uint64_t MulAddLimbs(std::span<uint64_t> out, std::span<const uint64_t> x, uint64_t factor) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    uint64_t high = 0;
+    auto low = MulWide(x[i], factor, high);
+    low += carry;
+    high += static_cast<uint64_t>(low < carry);
+    out[i] += low;
+    carry = high + static_cast<uint64_t>(out[i] < low);
+  }
+  return carry;
+}
+
+// out[0, x.size()) -= x * factor, returns the limb borrowed beyond.
+inline uint64_t MulSubLimbs(std::span<uint64_t> out, std::span<const uint64_t> x, uint64_t factor) {
+  uint64_t carry = 0;
+  for (size_t i = 0; i < x.size(); ++i) {
+    uint64_t high = 0;
+    auto low = MulWide(x[i], factor, high);
+    low += carry;
+    high += static_cast<uint64_t>(low < carry);
+    carry = high + static_cast<uint64_t>(out[i] < low);
+    out[i] -= low;
+  }
+  return carry;
+}
+
+// x /= divisor in place, returns the remainder.
+inline uint64_t DivLimbs(std::span<uint64_t> x, uint64_t divisor) {
+  uint64_t remainder = 0;
+  for (size_t i = x.size(); i-- > 0;) {
+    if (remainder == 0 && x[i] < divisor) {
+      remainder = x[i];
+      x[i] = 0;
+    } else {
+      x[i] = DivWide(remainder, x[i], divisor, remainder);
+    }
+  }
+  return remainder;
+}
+
+// Operands of at least this many limbs are multiplied by Karatsuba's method, shorter ones by the schoolbook one.
+constexpr size_t kKaratsubaThreshold = 32;
+
+// out[0, x.size() + y.size()) = x * y; out must not overlap the operands.
+inline void MulLimbs(std::span<uint64_t> out, std::span<const uint64_t> x, std::span<const uint64_t> y) {
+  if (x.size() < y.size()) {
+    std::swap(x, y);
+  }
+  if (y.size() < kKaratsubaThreshold) {
+    std::fill(out.begin(), out.end(), 0);
+    for (size_t i = 0; i < y.size(); ++i) {
+      out[i + x.size()] = MulAddLimbs(out.subspan(i, x.size()), x, y[i]);
+    }
+    return;
+  }
+  if (x.size() >= 2 * y.size()) {
+    // Unbalanced operands: x is cut into pieces as long as y.
+    std::fill(out.begin(), out.end(), 0);
+    std::vector<uint64_t> product(2 * y.size());
+    for (size_t begin = 0; begin < x.size(); begin += y.size()) {
+      const auto piece = x.subspan(begin, std::min(y.size(), x.size() - begin));
+      const auto piece_product = std::span(product).first(piece.size() + y.size());
+      MulLimbs(piece_product, piece, y);
+      AddLimbs(out.subspan(begin), piece_product);
+    }
+    return;
+  }
+
+  // With x = x1 B^half + x0, y = y1 B^half + y0 and B = 2^64, three products of halves replace four:
+  // x y = z2 B^(2 half) + (z1 - z2 - z0) B^half + z0 for z0 = x0 y0, z2 = x1 y1 and z1 = (x0 + x1)(y0 + y1).
+  const auto half = x.size() / 2;
+  const auto x0 = x.first(half);
+  const auto x1 = x.subspan(half);
+  const auto y0 = y.first(half);
+  const auto y1 = y.subspan(half);
+  MulLimbs(out.first(2 * half), x0, y0);
+  MulLimbs(out.subspan(2 * half), x1, y1);
+  // x1 is at least as long as x0, while y1 may be shorter or longer than y0.
+  std::vector<uint64_t> x_sum(x1.begin(), x1.end());
+  x_sum.push_back(0);
+  AddLimbs(x_sum, x0);
+  const auto y_long = y1.size() > y0.size() ? y1 : y0;
+  const auto y_short = y1.size() > y0.size() ? y0 : y1;
+  std::vector<uint64_t> y_sum(y_long.begin(), y_long.end());
+  y_sum.push_back(0);
+  AddLimbs(y_sum, y_short);
+  std::vector<uint64_t> middle(x_sum.size() + y_sum.size());
+  MulLimbs(middle, x_sum, y_sum);
+  SubLimbs(middle, out.first(2 * half));
+  SubLimbs(middle, out.subspan(2 * half));
+  // x0 y1 + x1 y0 fits into the limbs of out from half on, so the top limbs of middle that do not are zero.
+  const auto rest = out.subspan(half);
+  AddLimbs(rest, std::span<const uint64_t>(middle).first(std::min(middle.size(), rest.size())));
+}
+
+// Limbs of a BigUint: up to kInlineLimbs of them (256 bits) live inside the object, so numbers of that size never touch
+// the heap; longer ones move to a buffer that grows geometrically.
+class LimbVector {
+ public:
+  static constexpr size_t kInlineLimbs = 4;
+
+  LimbVector() = default;
+
+  LimbVector(const LimbVector& other) {
+    Assign(other.View());
+  }
+
+  LimbVector(LimbVector&& other) noexcept {
+    Steal(other);
+  }
+
+  LimbVector& operator=(const LimbVector& other) {
+    if (this != &other) {
+      Assign(other.View());
+    }
+    return *this;
+  }
+
+  LimbVector& operator=(LimbVector&& other) noexcept {
+    if (this != &other) {
+      heap_.reset();
+      capacity_ = kInlineLimbs;
+      Steal(other);
+    }
+    return *this;
+  }
+
+  ~LimbVector() = default;
+
+  size_t Size() const {
+    return size_;
+  }
+
+  bool Empty() const {
+    return size_ == 0;
+  }
+
+  uint64_t* Data() {
+    return heap_ ? heap_.get() : inline_;
+  }
+
+  const uint64_t* Data() const {
+    return heap_ ? heap_.get() : inline_;
+  }
+
+  uint64_t& operator[](size_t index) {
+    return Data()[index];
+  }
+
+  uint64_t operator[](size_t index) const {
+    return Data()[index];
+  }
+
+  uint64_t Back() const {
+    return Data()[size_ - 1];
+  }
+
+  std::span<uint64_t> View() {
+    return {Data(), size_};
+  }
+
+  std::span<const uint64_t> View() const {
+    return {Data(), size_};
+  }
+
+  void Reserve(size_t capacity) {
+    if (capacity <= capacity_) {
+      return;
+    }
+    capacity = std::max(capacity, 2 * capacity_);
+    std::unique_ptr<uint64_t[]> heap(new uint64_t[capacity]);
+    std::copy_n(Data(), size_, heap.get());
+    heap_ = std::move(heap);
+    capacity_ = capacity;
+  }
+
+  // New limbs are zero.
+  void Resize(size_t size) {
+    Reserve(size);
+    if (size > size_) {
+      std::fill(Data() + size_, Data() + size, 0);
+    }
+    size_ = size;
+  }
+
+  void PushBack(uint64_t limb) {
+    Reserve(size_ + 1);
+    Data()[size_++] = limb;
+  }
+
+  void PopBack() {
+    --size_;
+  }
+
+  void Assign(std::span<const uint64_t> limbs) {
+    size_ = 0;
+    Reserve(limbs.size());
+    std::copy(limbs.begin(), limbs.end(), Data());
+    size_ = limbs.size();
+  }
+
+ private:
+  void Steal(LimbVector& other) {
+    if (other.heap_) {
+      heap_ = std::move(other.heap_);
+      capacity_ = other.capacity_;
+    } else {
+      std::copy_n(other.inline_, other.size_, inline_);
+    }
+    size_ = other.size_;
+    other.size_ = 0;
+    other.capacity_ = kInlineLimbs;
+  }
+
+  uint64_t inline_[kInlineLimbs] = {};
+  std::unique_ptr<uint64_t[]> heap_;
+  size_t size_ = 0;
+  size_t capacity_ = kInlineLimbs;
+};
+
+}  // namespace gcd_internal
+
+// Arbitrary-precision non-negative integer stored as 64-bit limbs, least significant first, without leading zero limbs.
+class BigUint {
+ public:
+  BigUint() = default;
+
+  explicit BigUint(uint64_t value) {
+    if (value != 0) {
+      limbs_.PushBack(value);
+    }
+  }
+
+  // Little-endian limbs, leading zeros are allowed.
+  explicit BigUint(std::span<const uint64_t> limbs) {
+    limbs_.Assign(limbs);
+    Normalize();
+  }
+
+  // Decimal digits only, throws BigUintInvalidString otherwise.
+  explicit BigUint(std::string_view decimal) {
+    if (decimal.empty()) {
+      throw BigUintInvalidString{};
+    }
+    while (!decimal.empty()) {
+      const auto length = std::min(decimal.size(), kDecimalChunkDigits);
+      uint64_t chunk = 0;
+      uint64_t scale = 1;
+      for (const auto symbol : decimal.substr(0, length)) {
+        if (symbol < '0' || symbol > '9') {
+          throw BigUintInvalidString{};
+        }
+        chunk = chunk * 10 + static_cast<uint64_t>(symbol - '0');
+        scale *= 10;
+      }
+      MulAdd(scale, chunk);
+      decimal.remove_prefix(length);
+    }
+  }
+
+  std::span<const uint64_t> Limbs() const {
+    return limbs_.View();
+  }
+
+  // Limb with the given index, zero above the most significant one.
+  uint64_t Limb(size_t index) const {
+    return index < limbs_.Size() ? limbs_[index] : 0;
+  }
+
+  bool IsZero() const {
+    return limbs_.Empty();
+  }
+
+  size_t BitWidth() const {
+    return limbs_.Empty() ? 0 : 64 * limbs_.Size() - static_cast<size_t>(std::countl_zero(limbs_.Back()));
+  }
+
+  // Bits [shift, shift + 64) as a number.
+  uint64_t Bits(size_t shift) const {
+    const auto index = shift / 64;
+    const auto offset = shift % 64;
+    const auto low = Limb(index) >> offset;
+    return offset == 0 ? low : low | Limb(index + 1) << (64 - offset);
+  }
+
+  std::string ToString() const {
+    if (IsZero()) {
+      return "0";
+    }
+    auto rest = limbs_;
+    std::string digits;
+    while (!rest.Empty()) {
+      auto chunk = gcd_internal::DivLimbs(rest.View(), kDecimalChunk);
+      while (!rest.Empty() && rest.Back() == 0) {
+        rest.PopBack();
+      }
+      for (size_t i = 0; i < kDecimalChunkDigits && (chunk != 0 || !rest.Empty()); ++i) {
+        digits.push_back(static_cast<char>('0' + chunk % 10));
+        chunk /= 10;
+      }
+    }
+    std::reverse(digits.begin(), digits.end());
+    return digits;
+  }
+
+  BigUint& operator+=(const BigUint& other) {
+    limbs_.Resize(std::max(limbs_.Size(), other.limbs_.Size()));
+    if (gcd_internal::AddLimbs(limbs_.View(), other.limbs_.View()) != 0) {
+      limbs_.PushBack(1);
+    }
+    return *this;
+  }
+
+  // Throws BigUintUnderflow if other is greater.
+  BigUint& operator-=(const BigUint& other) {
+    if (*this < other) {
+      throw BigUintUnderflow{};
+    }
+    gcd_internal::SubLimbs(limbs_.View(), other.limbs_.View());
+    Normalize();
+    return *this;
+  }
+
+  BigUint& operator*=(const BigUint& other) {
+    if (IsZero() || other.IsZero()) {
+      limbs_.Resize(0);
+      return *this;
+    }
+    gcd_internal::LimbVector product;
+    product.Resize(limbs_.Size() + other.limbs_.Size());
+    gcd_internal::MulLimbs(product.View(), limbs_.View(), other.limbs_.View());
+    limbs_ = std::move(product);
+    Normalize();
+    return *this;
+  }
+
+  BigUint& operator/=(const BigUint& other) {
+    *this = DivMod(*this, other).first;
+    return *this;
+  }
+
+  BigUint& operator%=(const BigUint& other) {
+    *this = DivMod(*this, other).second;
+    return *this;
+  }
+
+  BigUint& operator<<=(size_t shift) {
+    if (IsZero()) {
+      return *this;
+    }
+    const auto limb_shift = shift / 64;
+    const auto bit_shift = shift % 64;
+    const auto size = limbs_.Size();
+    limbs_.Resize(size + limb_shift + 1);
+    for (size_t i = size + 1; i-- > 0;) {
+      const auto high = i < size ? limbs_[i] << bit_shift : 0;
+      const auto low = i > 0 && bit_shift != 0 ? limbs_[i - 1] >> (64 - bit_shift) : 0;
+      limbs_[i + limb_shift] = high | low;
+    }
+    std::fill_n(limbs_.Data(), limb_shift, 0);
+    Normalize();
+    return *this;
+  }
+
+  BigUint& operator>>=(size_t shift) {
+    const auto limb_shift = shift / 64;
+    if (limb_shift >= limbs_.Size()) {
+      limbs_.Resize(0);
+      return *this;
+    }
+    const auto size = limbs_.Size() - limb_shift;
+    for (size_t i = 0; i < size; ++i) {
+      limbs_[i] = Bits(shift + 64 * i);
+    }
+    limbs_.Resize(size);
+    Normalize();
+    return *this;
+  }
+
+  // Quotient and remainder of a / b, throws BigUintDivisionByZero for b == 0. Long divisors with long quotients go
+  // through a Newton reciprocal, which brings the cost down to that of a few multiplications.
+  static std::pair<BigUint, BigUint> DivMod(const BigUint& a, const BigUint& b) {
+    if (b.IsZero()) {
+      throw BigUintDivisionByZero{};
+    }
+    if (a < b) {
+      return {BigUint{}, a};
+    }
+    if (b.limbs_.Size() >= kNewtonThreshold && a.limbs_.Size() - b.limbs_.Size() >= kNewtonThreshold) {
+      return NewtonDivMod(a, b);
+    }
+    return SchoolbookDivMod(a, b);
+  }
+
+  friend bool operator==(const BigUint& lhs, const BigUint& rhs) {
+    return std::ranges::equal(lhs.Limbs(), rhs.Limbs());
+  }
+
+  friend std::strong_ordering operator<=>(const BigUint& lhs, const BigUint& rhs) {
+    if (lhs.limbs_.Size() != rhs.limbs_.Size()) {
+      return lhs.limbs_.Size() <=> rhs.limbs_.Size();
+    }
+    for (size_t i = lhs.limbs_.Size(); i-- > 0;) {
+      if (lhs.limbs_[i] != rhs.limbs_[i]) {
+        return lhs.limbs_[i] <=> rhs.limbs_[i];
+      }
+    }
+    return std::strong_ordering::equal;
+  }
+
+  friend BigUint Gcd(BigUint a, BigUint b);
+
+ private:
+  // 10^19, the largest power of ten in a limb.
+  static constexpr uint64_t kDecimalChunk = 10'000'000'000'000'000'000u;
+  static constexpr size_t kDecimalChunkDigits = 19;
+
+  void Normalize() {
+    while (!limbs_.Empty() && limbs_.Back() == 0) {
+      limbs_.PopBack();
+    }
+  }
+
+  // Divisors and quotients of at least this many limbs make DivMod use NewtonDivMod.
+  static constexpr size_t kNewtonThreshold = 1024;
+
+  // Knuth's algorithm D for a >= b > 0.
+  static std::pair<BigUint, BigUint> SchoolbookDivMod(const BigUint& a, const BigUint& b) {
+    if (b.limbs_.Size() == 1) {
+      auto quotient = a;
+      const auto remainder = gcd_internal::DivLimbs(quotient.limbs_.View(), b.limbs_[0]);
+      quotient.Normalize();
+      return {std::move(quotient), BigUint(remainder)};
+    }
+
+    // Both operands are shifted so that the divisor's top bit is set, which makes each quotient estimate from the top
+    // limbs at most 2 too large.
+    const auto shift = static_cast<size_t>(std::countl_zero(b.limbs_.Back()));
+    auto divisor = b;
+    divisor <<= shift;
+    auto rest = a;
+    rest <<= shift;
+    const auto n = divisor.limbs_.Size();
+    const auto m = a.limbs_.Size() - n;
+    rest.limbs_.Resize(m + n + 1);
+    BigUint quotient;
+    quotient.limbs_.Resize(m + 1);
+    const auto top = divisor.limbs_[n - 1];
+    const auto second = divisor.limbs_[n - 2];
+    for (size_t j = m + 1; j-- > 0;) {
+      auto& r = rest.limbs_;
+      uint64_t estimate = 0;
+      uint64_t estimate_rest = 0;
+      bool rest_overflow = false;
+      if (r[j + n] >= top) {
+        estimate = ~uint64_t{0};
+        estimate_rest = r[j + n - 1] + top;
+        rest_overflow = estimate_rest < top;
+      } else {
+        estimate = gcd_internal::DivWide(r[j + n], r[j + n - 1], top, estimate_rest);
+      }
+      while (!rest_overflow) {
+        uint64_t high = 0;
+        const auto low = gcd_internal::MulWide(estimate, second, high);
+        if (high < estimate_rest || (high == estimate_rest && low <= r[j + n - 2])) {
+          break;
+        }
+        --estimate;
+        estimate_rest += top;
+        rest_overflow = estimate_rest < top;
+      }
+      const auto borrow = gcd_internal::MulSubLimbs(r.View().subspan(j, n), divisor.limbs_.View(), estimate);
+      const auto head = r[j + n];
+      r[j + n] = head - borrow;
+      if (head < borrow) {
+        --estimate;
+        r[j + n] += gcd_internal::AddLimbs(r.View().subspan(j, n), divisor.limbs_.View());
+      }
+      quotient.limbs_[j] = estimate;
+    }
+    quotient.Normalize();
+    rest.Normalize();
+    rest >>= shift;
+    return {std::move(quotient), std::move(rest)};
+  }
+
+  // floor(2^(64 n) / d) for a divisor d of at most n limbs.
+  static BigUint Reciprocal(const BigUint& d, size_t n);
+
+  // a / b through the reciprocal of b to the precision of a.
+  static std::pair<BigUint, BigUint> NewtonDivMod(const BigUint& a, const BigUint& b);
+
+  // *this = *this * factor + addend.
+  void MulAdd(uint64_t factor, uint64_t addend) {
+    uint64_t carry = addend;
+    for (auto& limb : limbs_.View()) {
+      uint64_t high = 0;
+      limb = gcd_internal::MulWide(limb, factor, high);
+      limb += carry;
+      carry = high + static_cast<uint64_t>(limb < carry);
+    }
+    if (carry != 0) {
+      limbs_.PushBack(carry);
+    }
+  }
+
+  // out = x * x_factor + y * y_factor for signed factors given modulo 2^64, one of them not positive and the result
+  // known to be non-negative. This is how a step matrix of Lehmer's algorithm is applied.
+  static void Combine(const BigUint& x, uint64_t x_factor, const BigUint& y, uint64_t y_factor, BigUint& out) {
+    const auto x_positive = static_cast<int64_t>(x_factor) > 0;
+    const auto& plus = x_positive ? x : y;
+    const auto& minus = x_positive ? y : x;
+    const auto plus_factor = x_positive ? x_factor : y_factor;
+    const auto minus_factor = 0 - (x_positive ? y_factor : x_factor);
+    const auto size = std::max(x.limbs_.Size(), y.limbs_.Size());
+    out.limbs_.Resize(size);
+    uint64_t plus_carry = 0;
+    uint64_t minus_carry = 0;
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < size; ++i) {
+      uint64_t plus_high = 0;
+      auto plus_low = gcd_internal::MulWide(plus.Limb(i), plus_factor, plus_high);
+      plus_low += plus_carry;
+      plus_carry = plus_high + static_cast<uint64_t>(plus_low < plus_carry);
+      uint64_t minus_high = 0;
+      auto minus_low = gcd_internal::MulWide(minus.Limb(i), minus_factor, minus_high);
+      minus_low += minus_carry;
+      minus_carry = minus_high + static_cast<uint64_t>(minus_low < minus_carry);
+      const auto difference = plus_low - minus_low;
+      const auto next_borrow = static_cast<uint64_t>(plus_low < minus_low);
+      out.limbs_[i] = difference - borrow;
+      borrow = next_borrow | static_cast<uint64_t>(difference < borrow);
+    }
+    out.Normalize();
+  }
+
+  gcd_internal::LimbVector limbs_;
+};
+
+inline BigUint operator+(BigUint lhs, const BigUint& rhs) {
+  return lhs += rhs;
+}
+
+inline BigUint operator-(BigUint lhs, const BigUint& rhs) {
+  return lhs -= rhs;
+}
+
+inline BigUint operator*(BigUint lhs, const BigUint& rhs) {
+  return lhs *= rhs;
+}
+
+inline BigUint operator/(const BigUint& lhs, const BigUint& rhs) {
+  return BigUint::DivMod(lhs, rhs).first;
+}
+
+inline BigUint operator%(const BigUint& lhs, const BigUint& rhs) {
+  return BigUint::DivMod(lhs, rhs).second;
+}
+
+inline BigUint operator<<(BigUint lhs, size_t shift) {
+  return lhs <<= shift;
+}
+
+inline BigUint operator>>(BigUint lhs, size_t shift) {
+  return lhs >>= shift;
+}
+
+// The top half of the reciprocal comes from a recursive call on the top limbs of d, and one Newton step
+// x += x (2^(64 n) - d x) / 2^(64 n) doubles its precision, leaving an error of a few units that the final corrections
+// remove.
+inline BigUint BigUint::Reciprocal(const BigUint& d, size_t n) {
+  const auto power = BigUint(1) << (64 * n);
+  const auto d_size = d.limbs_.Size();
+  const auto precision = n - d_size;
+  if (precision < kNewtonThreshold) {
+    return SchoolbookDivMod(power, d).first;
+  }
+  const auto half = precision / 2 + 1;
+  const auto top = std::min(d_size, half + 1);
+  auto x = Reciprocal(d >> (64 * (d_size - top)), top + half) << (64 * (precision - half));
+  const auto product = d * x;
+  if (product <= power) {
+    x += (x * (power - product)) >> (64 * n);
+  } else {
+    x -= (x * (product - power)) >> (64 * n);
+  }
+  auto estimate = d * x;
+  while (estimate > power) {
+    x -= BigUint(1);
+    estimate -= d;
+  }
+  auto rest = power - estimate;
+  while (rest >= d) {
+    x += BigUint(1);
+    rest -= d;
+  }
+  return x;
+}
+
+// The reciprocal is at most the exact 2^(64 n) / b, so the quotient estimate undershoots by at most 2.
+inline std::pair<BigUint, BigUint> BigUint::NewtonDivMod(const BigUint& a, const BigUint& b) {
+  const auto n = a.limbs_.Size();
+  auto quotient = (a * Reciprocal(b, n)) >> (64 * n);
+  auto rest = a - quotient * b;
+  while (rest >= b) {
+    rest -= b;
+    quotient += BigUint(1);
+  }
+  return {std::move(quotient), std::move(rest)};
+}
+
+inline std::ostream& operator<<(std::ostream& out, const BigUint& value) {
+  return out << value.ToString();
+}
+
+inline std::istream& operator>>(std::istream& in, BigUint& value) {
+  std::string token;
+  if (in >> token) {
+    try {
+      value = BigUint(token);
+    } catch (const BigUintInvalidString&) {
+      in.setstate(std::ios_base::failbit);
+    }
+  }
+  return in;
+}
+
+// Lehmer's algorithm on 63-bit leading digits: each round finds a run of quotients with single-limb divisions and
+// applies it to the full numbers in two linear passes, instead of one long division per quotient. Numbers that fit into
+// a limb finish with the binary Gcd. A subquadratic half-GCD would only pay off far above 4096 bits (64 limbs), the
+// sizes this type is made for, so there is none.
+inline BigUint Gcd(BigUint a, BigUint b) {
+  if (a < b) {
+    std::swap(a, b);
+  }
+  BigUint next_a;
+  BigUint next_b;
+  while (!b.IsZero()) {
+    if (a.limbs_.Size() == 1) {
+      return BigUint(Gcd(a.limbs_[0], b.Limb(0)));
+    }
+    const auto shift = a.BitWidth() - 63;
+    const auto matrix = gcd_internal::LehmerSteps(a.Bits(shift), b.Bits(shift));
+    if (matrix.b == 0) {
+      a %= b;
+      std::swap(a, b);
+    } else {
+      BigUint::Combine(a, matrix.a, b, matrix.b, next_a);
+      BigUint::Combine(a, matrix.c, b, matrix.d, next_b);
+      std::swap(a, next_a);
+      std::swap(b, next_b);
+    }
+  }
+  return a;
+}
+
+#endif
@@ -0,0 +1,245 @@
+#pragma once
+#ifndef FACTORIZE_HPP
+#define FACTORIZE_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "big_uint.hpp"
+#include "gcd.hpp"
+#include "mod_int.hpp"
+#include "parallel/parallel.hpp"
+
+class FactorizeZero : public std::invalid_argument {
+ public:
+  FactorizeZero() : std::invalid_argument("FactorizeZero") {
+  }
+};
+
+// Factorize divides by every prime below this bound before it turns to Pollard's rho, so numbers below its square that
+// are left over are prime.
+inline constexpr uint32_t kFactorizeTrialBound = 1024;
+
+// Steps of Pollard's rho whose differences are multiplied together before a single Gcd with the number.
+inline constexpr size_t kPollardRhoBatch = 128;
+
+namespace gcd_internal {
+
+template <uint32_t kBound>
+constexpr std::array<bool, kBound> CompositeSieve() {
+  std::array<bool, kBound> composite{};
+  composite[0] = true;
+  composite[1] = true;
+  for (uint32_t i = 2; i * i < kBound; ++i) {
+    if (!composite[i]) {
+      for (auto j = i * i; j < kBound; j += i) {
+        composite[j] = true;
+      }
+    }
+  }
+  return composite;
+}
+
+template <uint32_t kBound>
+constexpr auto SmallPrimes() {
+  constexpr auto composite = CompositeSieve<kBound>();
+  std::array<uint32_t, std::count(composite.begin(), composite.end(), false)> primes{};
+  size_t next = 0;
+  for (uint32_t i = 0; i < kBound; ++i) {
+    if (!composite[i]) {
+      primes[next++] = i;
+    }
+  }
+  return primes;
+}
+
+// The primes below kFactorizeTrialBound in ascending order.
+inline constexpr auto kSmallPrimes = SmallPrimes<kFactorizeTrialBound>();
+
+// The type Factorize works in for T: a single limb up to 64 bits, two limbs above.
+template <class T>
+struct FactorWordOf {
+  using Type = uint64_t;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct FactorWordOf<Uint128> {
+  using Type = Uint128;
+};
+#endif
+
+template <class T>
+using FactorWord = typename FactorWordOf<T>::Type;
+
+// Strong probable prime test of n = mont.Modulus() to the given base.
+template <class U>
+bool MillerRabin(const Montgomery<U>& mont, U base) {
+  const auto n = mont.Modulus();
+  if (base % n == 0) {
+    return true;
+  }
+  const auto zeros = std::countr_zero(static_cast<U>(n - 1));
+  const auto minus_one = n - mont.One();
+  auto x = mont.Pow(mont.To(base), (n - 1) >> zeros);
+  if (x == mont.One() || x == minus_one) {
+    return true;
+  }
+  for (int i = 1; i < zeros; ++i) {
+    x = mont.Mul(x, x);
+    if (x == minus_one) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// Primality of an odd n without prime factors below kFactorizeTrialBound. Below 2^64 the seven bases of Jim Sinclair
+// make Miller-Rabin exact, and the first 13 primes do so below 3.3 * 10^24; above that the first 24 primes are tried,
+// which leaves the answer probabilistic only for composites that are strong pseudoprimes to all of them.
+template <class U>
+bool IsPrimeOdd(U n) {
+  if (n < U{kFactorizeTrialBound} * kFactorizeTrialBound) {
+    return true;
+  }
+  if constexpr (std::is_same_v<U, uint64_t>) {
+    const Montgomery<U> mont(n);
+    constexpr uint64_t kBases[] = {2, 325, 9375, 28178, 450775, 9780504, 1795265022};
+    return std::ranges::all_of(kBases, [&](uint64_t base) {
+      return MillerRabin(mont, base);
+    });
+  } else {
+    if (n >> 64 == 0) {
+      return IsPrimeOdd(static_cast<uint64_t>(n));
+    }
+    const Montgomery<U> mont(n);
+    const auto num_bases = n >> 81 == 0 ? 13 : 24;
+    return std::all_of(kSmallPrimes.begin(), kSmallPrimes.begin() + num_bases, [&](uint32_t base) {
+      return MillerRabin(mont, U{base});
+    });
+  }
+}
+
+// A proper divisor of an odd composite n by Brent's variant of Pollard's rho on x^2 + c: it advances one walker in
+// runs of doubling length and compares it with the other's position at the start of the run. The differences are
+// multiplied modulo n and a single Gcd is taken per kPollardRhoBatch steps; if that product collapses to 0 the batch is
+// replayed one step at a time, and a cycle that still finds only n moves on to the next c.
+template <class U>
+U PollardRho(U n) {
+  const Montgomery<U> mont(n);
+  for (U c = 1;; ++c) {
+    const auto step = [&](U x) {
+      return mont.Add(mont.Mul(x, x), c);
+    };
+    auto y = mont.To(c + 1);
+    auto x = y;
+    auto saved = y;
+    auto product = mont.One();
+    U divisor = 1;
+    for (size_t run = 1; divisor == 1; run *= 2) {
+      x = y;
+      for (size_t i = 0; i < run; ++i) {
+        y = step(y);
+      }
+      for (size_t done = 0; done < run && divisor == 1; done += kPollardRhoBatch) {
+        saved = y;
+        for (size_t i = 0; i < std::min(kPollardRhoBatch, run - done); ++i) {
+          y = step(y);
+          product = mont.Mul(product, mont.Sub(x, y));
+        }
+        divisor = Gcd(product, n);
+      }
+    }
+    if (divisor == n) {
+      do {
+        saved = step(saved);
+        divisor = Gcd(mont.Sub(x, saved), n);
+      } while (divisor == 1);
+    }
+    if (divisor != n) {
+      return divisor;
+    }
+  }
+}
+
+// Appends the prime factors of an odd n > 1 without factors below kFactorizeTrialBound, in no particular order.
+// Cofactors that fit into 64 bits go on in single-limb arithmetic.
+template <class U, class T>
+void AppendPrimeFactors(U n, std::vector<T>& factors) {
+  if constexpr (!std::is_same_v<U, uint64_t>) {
+    if (n <= std::numeric_limits<uint64_t>::max()) {
+      AppendPrimeFactors(static_cast<uint64_t>(n), factors);
+      return;
+    }
+  }
+  if (IsPrimeOdd(n)) {
+    factors.push_back(static_cast<T>(n));
+    return;
+  }
+  const auto divisor = PollardRho(n);
+  AppendPrimeFactors(divisor, factors);
+  AppendPrimeFactors(n / divisor, factors);
+}
+
+}  // namespace gcd_internal
+
+// Whether n is prime, for unsigned integers of up to 128 bits. Exact below 3.3 * 10^24, see gcd_internal::IsPrimeOdd.
+template <class T>
+bool IsPrime(T n) {
+  static_assert(std::is_same_v<T, gcd_internal::Unsigned<T>>, "IsPrime takes unsigned integers");
+  if (n < 2) {
+    return false;
+  }
+  for (const auto prime : gcd_internal::kSmallPrimes) {
+    if (n % prime == 0) {
+      return n == prime;
+    }
+  }
+  return gcd_internal::IsPrimeOdd(static_cast<gcd_internal::FactorWord<T>>(n));
+}
+
+// Prime factors of n > 0 in ascending order, repeated by multiplicity, for unsigned integers of up to 128 bits; throws
+// FactorizeZero for 0. Trial division by gcd_internal::kSmallPrimes takes out the small factors, what is left is split
+// by Pollard's rho, which is fast while the second largest prime factor has up to about 40 bits.
+template <class T>
+std::vector<T> Factorize(T n) {
+  static_assert(std::is_same_v<T, gcd_internal::Unsigned<T>>, "Factorize takes unsigned integers");
+  if (n == 0) {
+    throw FactorizeZero{};
+  }
+  std::vector<T> factors;
+  for (const auto prime : gcd_internal::kSmallPrimes) {
+    if (n / prime < prime) {
+      break;
+    }
+    while (n % prime == 0) {
+      factors.push_back(static_cast<T>(prime));
+      n /= prime;
+    }
+  }
+  if (n > 1) {
+    gcd_internal::AppendPrimeFactors(static_cast<gcd_internal::FactorWord<T>>(n), factors);
+  }
+  std::sort(factors.begin(), factors.end());
+  return factors;
+}
+
+// Factorize of every value, spread over num_threads threads (0 means one per hardware thread).
+template <class T>
+std::vector<std::vector<T>> FactorizeMany(std::span<const T> values, size_t num_threads = 0) {
+  std::vector<std::vector<T>> factors(values.size());
+  parallel_internal::ParallelFor(values.size(), num_threads, [&](size_t i) {
+    factors[i] = Factorize(values[i]);
+  });
+  return factors;
+}
+
+#endif
@@ -0,0 +1,625 @@
+#pragma once
+#ifndef GCD_HPP
+#define GCD_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "parallel/parallel.hpp"
+
+class GcdSizeMismatch : public std::invalid_argument {
+ public:
+  GcdSizeMismatch() : std::invalid_argument("GcdSizeMismatch") {
+  }
+};
+
+namespace gcd_internal {
+
+// Binary (Stein's) GCD: strips common factors of two with countr_zero and replaces the division of Euclid's algorithm
+// with a subtraction and a shift. The trailing zeros are counted on the wrapped difference y - x, which has as many as
+// |y - x|, so the count runs in parallel with the min/abs selection (conditional moves) instead of after it.
+template <class U>
+constexpr U BinaryGcd(U x, U y) {
+  if (x == 0) {
+    return y;
+  }
+  if (y == 0) {
+    return x;
+  }
+  const auto shift = std::countr_zero(static_cast<U>(x | y));
+  x >>= std::countr_zero(x);
+  y >>= std::countr_zero(y);
+  while (x != y) {
+    const auto diff = static_cast<U>(y - x);
+    const auto zeros = std::countr_zero(diff);
+    const auto abs_diff = x < y ? diff : static_cast<U>(x - y);
+    x = x < y ? x : y;
+    y = static_cast<U>(abs_diff >> zeros);
+  }
+  return static_cast<U>(x << shift);
+}
+
+}  // namespace gcd_internal
+
+// Gcd of two operands that are both below GCD_SMALL_TABLE_SIZE is looked up in a table of GCD_SMALL_TABLE_SIZE^2
+// bytes built at compile time. The default 64 takes 4 KiB of L1; 256 covers every byte but takes 64 KiB, more than L1
+// on most cores. Must be a power of two up to 256, and 0 disables the table.
+#ifndef GCD_SMALL_TABLE_SIZE
+#define GCD_SMALL_TABLE_SIZE 64
+#endif
+
+inline constexpr size_t kGcdSmallTableSize = GCD_SMALL_TABLE_SIZE;
+static_assert(kGcdSmallTableSize <= 256 && (kGcdSmallTableSize == 0 || std::has_single_bit(kGcdSmallTableSize)),
+              "GCD_SMALL_TABLE_SIZE must be 0 or a power of two up to 256");
+
+namespace gcd_internal {
+
+// Operands below the table size have no bits at or above this one.
+inline constexpr int kGcdSmallTableBits = std::countr_zero(kGcdSmallTableSize);
+
+constexpr std::array<uint8_t, kGcdSmallTableSize * kGcdSmallTableSize> MakeGcdSmallTable() {
+  std::array<uint8_t, kGcdSmallTableSize * kGcdSmallTableSize> table{};
+  for (size_t x = 0; x < kGcdSmallTableSize; ++x) {
+    for (size_t y = 0; y < kGcdSmallTableSize; ++y) {
+      table[x * kGcdSmallTableSize + y] = static_cast<uint8_t>(BinaryGcd(x, y));
+    }
+  }
+  return table;
+}
+
+// table[x * kGcdSmallTableSize + y] == Gcd(x, y).
+inline constexpr auto kGcdSmallTable = MakeGcdSmallTable();
+
+}  // namespace gcd_internal
+
+// Greatest common divisor of two non-negative numbers, Gcd(0, 0) == 0.
+// Built-in integers use the binary algorithm after a single well-predicted check for small operands, which are looked
+// up in kGcdSmallTable instead; any other type with % falls back to Euclid's algorithm.
+template <class T>
+constexpr T Gcd(T x, T y) {
+  if constexpr (std::is_integral_v<T>) {
+    using Unsigned = std::make_unsigned_t<T>;
+    const auto ux = static_cast<Unsigned>(x);
+    const auto uy = static_cast<Unsigned>(y);
+    if constexpr (kGcdSmallTableSize > 0) {
+      if ((ux | uy) >> gcd_internal::kGcdSmallTableBits == 0) {
+        const auto index = static_cast<size_t>(ux) * kGcdSmallTableSize + static_cast<size_t>(uy);
+        return static_cast<T>(gcd_internal::kGcdSmallTable[index]);
+      }
+    }
+    return static_cast<T>(gcd_internal::BinaryGcd(ux, uy));
+  } else {
+    while (y != T{0}) {
+      x = x % y;
+      std::swap(x, y);
+    }
+    return x;
+  }
+}
+
+namespace gcd_internal {
+
+#ifdef __SIZEOF_INT128__
+__extension__ using Int128 = __int128;
+__extension__ using Uint128 = unsigned __int128;
+#endif
+
+// make_unsigned / make_signed that also know the 128-bit integers, which are not integral types in strict ISO mode.
+template <class T>
+struct UnsignedOf {
+  using Type = std::make_unsigned_t<T>;
+};
+
+template <class T>
+struct SignedOf {
+  using Type = std::make_signed_t<T>;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct UnsignedOf<Int128> {
+  using Type = Uint128;
+};
+
+template <>
+struct UnsignedOf<Uint128> {
+  using Type = Uint128;
+};
+
+template <>
+struct SignedOf<Int128> {
+  using Type = Int128;
+};
+
+template <>
+struct SignedOf<Uint128> {
+  using Type = Int128;
+};
+#endif
+
+template <class T>
+using Unsigned = typename UnsignedOf<T>::Type;
+
+template <class T>
+using Signed = typename SignedOf<T>::Type;
+
+// Integer type of twice the width and the same signedness; the widest type is its own Wider.
+template <class T>
+struct WiderOf {
+  using Type = T;
+};
+
+template <>
+struct WiderOf<int8_t> {
+  using Type = int16_t;
+};
+
+template <>
+struct WiderOf<uint8_t> {
+  using Type = uint16_t;
+};
+
+template <>
+struct WiderOf<int16_t> {
+  using Type = int32_t;
+};
+
+template <>
+struct WiderOf<uint16_t> {
+  using Type = uint32_t;
+};
+
+template <>
+struct WiderOf<int32_t> {
+  using Type = int64_t;
+};
+
+template <>
+struct WiderOf<uint32_t> {
+  using Type = uint64_t;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct WiderOf<int64_t> {
+  using Type = Int128;
+};
+
+template <>
+struct WiderOf<uint64_t> {
+  using Type = Uint128;
+};
+#endif
+
+template <class T>
+using Wider = typename WiderOf<T>::Type;
+
+// Half-width digit of the Lehmer loop, void for types that use plain Euclid. A 64-bit division is no slower than a
+// 32-bit one on current x86-64 cores, so Lehmer with 32-bit digits loses to Euclid there; 128-bit division is a library
+// call and the 64-bit digits pay off.
+template <class U>
+struct LehmerDigitOf {
+  using Type = void;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct LehmerDigitOf<Uint128> {
+  using Type = uint64_t;
+};
+#endif
+
+template <class U>
+constexpr int BitWidth(U x) {
+  if constexpr (sizeof(U) > sizeof(uint64_t)) {
+    const auto high = static_cast<uint64_t>(x >> 64);
+    return high != 0 ? 64 + std::bit_width(high) : std::bit_width(static_cast<uint64_t>(x));
+  } else {
+    return std::bit_width(x);
+  }
+}
+
+// Gcd with cofactors: gcd == a * x + b * y. Cofactors are kept modulo 2^bits: every intermediate one is at most b in
+// absolute value, so the final ones read back correctly as signed numbers.
+template <class U>
+struct ExtendedGcdState {
+  U r0, r1;
+  U x0, x1;
+  U y0, y1;
+
+  // One step of Euclid's algorithm with the quotient q.
+  constexpr void Step(U q) {
+    Rotate(q, r0, r1);
+    Rotate(q, x0, x1);
+    Rotate(q, y0, y1);
+  }
+
+  // Several steps at once: (u, v) := (a u + b v, c u + d v) for every pair, with signed a, b, c, d modulo 2^bits.
+  constexpr void Apply(U a, U b, U c, U d) {
+    Combine(a, b, c, d, r0, r1);
+    Combine(a, b, c, d, x0, x1);
+    Combine(a, b, c, d, y0, y1);
+  }
+
+  static constexpr void Rotate(U q, U& u, U& v) {
+    const auto next = static_cast<U>(u - q * v);
+    u = v;
+    v = next;
+  }
+
+  static constexpr void Combine(U a, U b, U c, U d, U& u, U& v) {
+    const auto next_u = static_cast<U>(a * u + b * v);
+    v = static_cast<U>(c * u + d * v);
+    u = next_u;
+  }
+};
+
+// Extended Euclid on remainders that fit into Digit: divisions run at the digit width, cofactors at the full one.
+template <class U, class Digit>
+constexpr void EuclidExtendedGcd(ExtendedGcdState<U>& state) {
+  auto u = static_cast<Digit>(state.r0);
+  auto v = static_cast<Digit>(state.r1);
+  while (v != 0) {
+    const auto q = static_cast<Digit>(u / v);
+    ExtendedGcdState<U>::Rotate(q, state.x0, state.x1);
+    ExtendedGcdState<U>::Rotate(q, state.y0, state.y1);
+    const auto next = static_cast<Digit>(u - q * v);
+    u = v;
+    v = next;
+  }
+  state.r0 = u;
+  state.r1 = 0;
+}
+
+// Signed entries of a 2x2 matrix kept modulo 2^bits.
+template <class Digit>
+struct LehmerMatrix {
+  Digit a = 1;
+  Digit b = 0;
+  Digit c = 0;
+  Digit d = 1;
+};
+
+// Inner loop of Lehmer's algorithm (Knuth, TAOCP 4.5.2, algorithm L). u >= v are the leading bits of two remainders,
+// both shifted by the same amount so that u has at most kDigitBits - 1 bits. Euclid runs on them as long as its
+// quotients provably match the ones of the full numbers; the returned matrix maps the full pair (x, y) to the pair
+// those steps lead to, (a x + b y, c x + d y). b == 0 means no step was certain and the caller needs a full division.
+template <class Digit>
+constexpr LehmerMatrix<Digit> LehmerSteps(Digit u, Digit v) {
+  LehmerMatrix<Digit> matrix;
+  // u + a, v + c etc. are never negative (Knuth), so they are computed modulo 2^bits as well.
+  while (true) {
+    const auto vc = static_cast<Digit>(v + matrix.c);
+    const auto vd = static_cast<Digit>(v + matrix.d);
+    if (vc == 0 || vd == 0) {
+      break;
+    }
+    const auto q = static_cast<Digit>(static_cast<Digit>(u + matrix.a) / vc);
+    if (q != static_cast<Digit>(u + matrix.b) / vd) {
+      break;
+    }
+    ExtendedGcdState<Digit>::Rotate(q, matrix.a, matrix.c);
+    ExtendedGcdState<Digit>::Rotate(q, matrix.b, matrix.d);
+    ExtendedGcdState<Digit>::Rotate(q, u, v);
+  }
+  return matrix;
+}
+
+// Lehmer's algorithm: the quotients are found on the leading digits of the remainders, and the collected steps are
+// applied to the full remainders and cofactors as one matrix. Most quotients cost a digit-width division instead of a
+// double-width one (a library call for 128 bits). Once the remainders fit into a digit, the rest is plain Euclid at
+// the digit width.
+template <class U, class Digit>
+constexpr void LehmerExtendedGcd(ExtendedGcdState<U>& state) {
+  using SignedDigit = std::make_signed_t<Digit>;
+  constexpr int kDigitBits = std::numeric_limits<Digit>::digits;
+  const auto widen = [](Digit digit) {
+    return static_cast<U>(static_cast<SignedDigit>(digit));
+  };
+  while (state.r1 != 0 && (state.r0 >> kDigitBits) != 0) {
+    const auto shift = BitWidth(state.r0) - (kDigitBits - 1);
+    const auto matrix = LehmerSteps(static_cast<Digit>(state.r0 >> shift), static_cast<Digit>(state.r1 >> shift));
+    if (matrix.b == 0) {
+      state.Step(static_cast<U>(state.r0 / state.r1));
+    } else {
+      state.Apply(widen(matrix.a), widen(matrix.b), widen(matrix.c), widen(matrix.d));
+    }
+  }
+  if (state.r1 != 0) {
+    EuclidExtendedGcd<U, Digit>(state);
+  }
+}
+
+}  // namespace gcd_internal
+
+template <class T>
+struct ExtendedGcdResult {
+  T gcd;
+  gcd_internal::Signed<T> x;
+  gcd_internal::Signed<T> y;
+
+  bool operator==(const ExtendedGcdResult&) const = default;
+};
+
+// Gcd(a, b) of two non-negative numbers together with Bezout coefficients: a * x + b * y == gcd. The coefficients are
+// the ones of Euclid's algorithm: |x| <= b / (2 gcd) and |y| <= a / (2 gcd) unless a or b divides the other one,
+// ExtendedGcd(a, 0) == {a, 1, 0} and ExtendedGcd(0, b) == {b, 0, 1}. 128-bit operands use Lehmer's algorithm.
+template <class T>
+constexpr ExtendedGcdResult<T> ExtendedGcd(T a, T b) {
+  using U = gcd_internal::Unsigned<T>;
+  using Digit = typename gcd_internal::LehmerDigitOf<U>::Type;
+  gcd_internal::ExtendedGcdState<U> state{static_cast<U>(a), static_cast<U>(b), 1, 0, 0, 1};
+  if (state.r0 < state.r1) {
+    state.Step(0);
+  }
+  if constexpr (std::is_void_v<Digit>) {
+    gcd_internal::EuclidExtendedGcd<U, U>(state);
+  } else {
+    gcd_internal::LehmerExtendedGcd<U, Digit>(state);
+  }
+  using S = gcd_internal::Signed<T>;
+  return {static_cast<T>(state.r0), static_cast<S>(state.x0), static_cast<S>(state.y0)};
+}
+
+// Inverse of a modulo m: the x in [0, m) with a * x = 1 (mod m), or nullopt if a and m are not coprime or m == 0.
+// Operands are non-negative.
+template <class T>
+constexpr std::optional<T> ModInverse(T a, T m) {
+  if (m == T{0}) {
+    return std::nullopt;
+  }
+  const auto result = ExtendedGcd<T>(static_cast<T>(a % m), m);
+  if (result.gcd != T{1}) {
+    return std::nullopt;
+  }
+  using U = gcd_internal::Unsigned<T>;
+  auto inverse = static_cast<U>(result.x);
+  if (result.x < 0) {
+    inverse += static_cast<U>(m);
+  }
+  return static_cast<T>(inverse);
+}
+
+namespace gcd_internal {
+
+// product = x * y, true if the product does not fit into T.
+template <class T>
+constexpr bool MulOverflow(T x, T y, T& product) {
+#if defined(__GNUC__)
+  return __builtin_mul_overflow(x, y, &product);
+#else
+  // Operands are non-negative here.
+  if (y != T{0} && x > std::numeric_limits<T>::max() / y) {
+    return true;
+  }
+  product = static_cast<T>(x * y);
+  return false;
+#endif
+}
+
+}  // namespace gcd_internal
+
+// Least common multiple of two non-negative numbers, Lcm(a, 0) == 0, or nullopt if it does not fit into T. The
+// division by the Gcd comes first, so only a result that itself overflows is reported.
+template <class T>
+constexpr std::optional<T> Lcm(T a, T b) {
+  if (a == T{0} || b == T{0}) {
+    return T{0};
+  }
+  T result{};
+  if (gcd_internal::MulOverflow(static_cast<T>(a / Gcd(a, b)), b, result)) {
+    return std::nullopt;
+  }
+  return result;
+}
+
+// Lcm of all values (1 for an empty span). The fold runs in T and moves to the type of twice the width only when the
+// running Lcm stops fitting into T, so the common case pays for no wide multiplications; nullopt if even the wide
+// type overflows (128-bit types have no wider one).
+template <class T>
+constexpr std::optional<gcd_internal::Wider<T>> LcmReduce(std::span<const T> values) {
+  using Wide = gcd_internal::Wider<T>;
+  T narrow{1};
+  size_t i = 0;
+  for (; i < values.size() && narrow != T{0}; ++i) {
+    const auto next = Lcm(narrow, values[i]);
+    if (!next) {
+      break;
+    }
+    narrow = *next;
+  }
+  Wide wide = narrow;
+  for (; i < values.size() && wide != Wide{0}; ++i) {
+    const auto next = Lcm(wide, static_cast<Wide>(values[i]));
+    if (!next) {
+      // Still exact if a zero follows.
+      if (std::find(values.begin() + static_cast<std::ptrdiff_t>(i), values.end(), T{0}) != values.end()) {
+        return Wide{0};
+      }
+      return std::nullopt;
+    }
+    wide = *next;
+  }
+  return wide;
+}
+
+// Function multiversioning for the batched kernel: an AVX2 and a generic clone, bound to the running CPU by the dynamic
+// loader. Clang does not accept target_clones on templates, so it gets the generic code only.
+#if defined(__GNUC__) && !defined(__clang__) && defined(__x86_64__) && defined(__linux__)
+#define GCD_MULTIVERSION __attribute__((target_clones("avx2", "default")))
+#else
+#define GCD_MULTIVERSION
+#endif
+
+namespace gcd_internal {
+
+// Pairs in flight in GcdMany and steps between two checks for finished pairs.
+constexpr size_t kGcdLanes = 32;
+constexpr int kGcdStepsPerCheck = 8;
+
+// Index of the bit set in low, a power of two, read from the exponent of its float value: countr_zero does not
+// vectorize, an integer to float conversion does. A 64-bit value is converted as the half that holds the bit. The
+// result for low == 0 is unspecified but within the width of W.
+template <class W>
+constexpr W LowBitIndex(W low) {
+  if constexpr (sizeof(W) == 4) {
+    const auto exponent = std::bit_cast<uint32_t>(static_cast<float>(static_cast<int32_t>(low))) >> 23;
+    return (exponent - 127) & 31;
+  } else {
+    const auto low_half = static_cast<uint32_t>(low);
+    const auto high_half = static_cast<uint32_t>(low >> 32);
+    return LowBitIndex<uint32_t>(low_half | high_half) + (low_half == 0 ? 32 : 0);
+  }
+}
+
+// kGcdStepsPerCheck binary GCD steps on every lane, branch-free so that the loop vectorizes. Once a pair reaches
+// x == y the steps only move its value between (g, 0) and (0, g), so finished lanes can keep running.
+template <class W>
+GCD_MULTIVERSION void GcdLaneSteps(W* __restrict x, W* __restrict y) {
+  for (int step = 0; step < kGcdStepsPerCheck; ++step) {
+    for (size_t lane = 0; lane < kGcdLanes; ++lane) {
+      const auto u = x[lane];
+      const auto v = y[lane];
+      const auto diff = static_cast<W>(v - u);
+      const auto back = static_cast<W>(u - v);
+      const auto zeros = LowBitIndex(static_cast<W>(diff & (W{0} - diff)));
+      const auto less = static_cast<W>(W{0} - (u < v));
+      x[lane] = v ^ ((u ^ v) & less);
+      y[lane] = (back ^ ((diff ^ back) & less)) >> zeros;
+    }
+  }
+}
+
+// A single GCD is one long chain of dependent steps, so the kernel keeps kGcdLanes independent pairs in flight and
+// advances them together. Narrow types run in 32-bit lanes. A finished lane is retired after each batch of steps: its
+// result is written out and the next pair is loaded into it, so no lane waits for the slowest pair of a block.
+template <class T>
+void GcdManyKernel(const T* a, const T* b, T* out, size_t size) {
+  using U = std::make_unsigned_t<T>;
+  using W = std::conditional_t<sizeof(T) <= 4, uint32_t, uint64_t>;
+  constexpr size_t kIdle = static_cast<size_t>(-1);
+
+  alignas(64) W x[kGcdLanes];
+  alignas(64) W y[kGcdLanes];
+  int shift[kGcdLanes];
+  size_t index[kGcdLanes];
+  size_t next = 0;
+  size_t active = 0;
+  // Loads the next pair that needs the loop into the lane; pairs with a zero are answered right away.
+  const auto load = [&](size_t lane) {
+    for (; next < size; ++next) {
+      const W u = static_cast<U>(a[next]);
+      const W v = static_cast<U>(b[next]);
+      if (u == 0 || v == 0) {
+        out[next] = static_cast<T>(u | v);
+        continue;
+      }
+      shift[lane] = std::countr_zero(static_cast<W>(u | v));
+      x[lane] = u >> std::countr_zero(u);
+      y[lane] = v >> std::countr_zero(v);
+      index[lane] = next++;
+      ++active;
+      return;
+    }
+    x[lane] = 1;
+    y[lane] = 0;
+    index[lane] = kIdle;
+  };
+  for (size_t lane = 0; lane < kGcdLanes; ++lane) {
+    load(lane);
+  }
+  while (active > 0) {
+    GcdLaneSteps(x, y);
+    for (size_t lane = 0; lane < kGcdLanes; ++lane) {
+      if ((x[lane] == 0 || y[lane] == 0) && index[lane] != kIdle) {
+        out[index[lane]] = static_cast<T>((x[lane] | y[lane]) << shift[lane]);
+        --active;
+        load(lane);
+      }
+    }
+  }
+}
+
+}  // namespace gcd_internal
+
+// out[i] = Gcd(a[i], b[i]) for every i, throws GcdSizeMismatch if the spans differ in size.
+template <class T>
+void GcdMany(std::span<const T> a, std::span<const T> b, std::span<T> out) {
+  if (a.size() != b.size() || a.size() != out.size()) {
+    throw GcdSizeMismatch{};
+  }
+  if constexpr (std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t)) {
+    gcd_internal::GcdManyKernel(a.data(), b.data(), out.data(), a.size());
+  } else {
+    for (size_t i = 0; i < a.size(); ++i) {
+      out[i] = Gcd(a[i], b[i]);
+    }
+  }
+}
+
+// Elements per chunk of GcdReduce; a smaller input is reduced by the calling thread alone.
+inline constexpr size_t kGcdReduceGrain = size_t{1} << 16;
+
+namespace gcd_internal {
+
+// Elements folded between two reads of the cancellation flag.
+constexpr size_t kGcdCancelCheckInterval = 1024;
+
+// Gcd of init and all values. Stops as soon as the result is 1, or when *done is set by another thread, in which case
+// the result is meaningless.
+template <class T>
+T GcdFold(T init, std::span<const T> values, const std::atomic<bool>* done) {
+  for (size_t begin = 0; begin < values.size(); begin += kGcdCancelCheckInterval) {
+    if (done != nullptr && done->load(std::memory_order_relaxed)) {
+      return init;
+    }
+    const auto end = std::min(values.size(), begin + kGcdCancelCheckInterval);
+    for (size_t i = begin; i < end; ++i) {
+      init = Gcd(init, values[i]);
+      if (init == T{1}) {
+        return init;
+      }
+    }
+  }
+  return init;
+}
+
+}  // namespace gcd_internal
+
+// Gcd of all values (0 for an empty span), computed on num_threads threads (0 means one per hardware thread) for inputs
+// longer than kGcdReduceGrain. The fold ends as soon as any thread reaches 1: it raises a shared flag that makes the
+// other threads drop their chunks, so the scan of typical data is over after a few elements.
+template <class T>
+T GcdReduce(std::span<const T> values, size_t num_threads = 0) {
+  const auto num_chunks = (values.size() + kGcdReduceGrain - 1) / kGcdReduceGrain;
+  if (parallel_internal::ResolveThreadCount(num_threads, num_chunks) == 1) {
+    return gcd_internal::GcdFold<T>(T{0}, values, nullptr);
+  }
+  std::atomic<bool> done = false;
+  std::vector<T> partial(num_chunks, T{0});
+  parallel_internal::ParallelFor(num_chunks, num_threads, [&](size_t chunk) {
+    const auto begin = chunk * kGcdReduceGrain;
+    const auto size = std::min(kGcdReduceGrain, values.size() - begin);
+    partial[chunk] = gcd_internal::GcdFold<T>(T{0}, values.subspan(begin, size), &done);
+    if (partial[chunk] == T{1}) {
+      done.store(true, std::memory_order_relaxed);
+    }
+  });
+  if (done.load(std::memory_order_relaxed)) {
+    return T{1};
+  }
+  return gcd_internal::GcdFold<T>(T{0}, std::span<const T>(partial), nullptr);
+}
+
+#endif
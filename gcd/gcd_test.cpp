@@ -3,9 +3,31 @@
 
 #include "gcd.hpp"
 #include "gcd.hpp"  // check include guards
+#include "big_uint.hpp"
+#include "big_uint.hpp"  // check include guards
+#include "batch_gcd.hpp"
+#include "batch_gcd.hpp"  // check include guards
+#include "all_pairs_gcd.hpp"
+#include "all_pairs_gcd.hpp"  // check include guards
+#include "factorize.hpp"
+#include "factorize.hpp"  // check include guards
+#include "polynomial.hpp"
+#include "polynomial.hpp"  // check include guards
+#include "mod_int.hpp"
+#include "mod_int.hpp"  // check include guards
 
 #include <type_traits>
+#include <algorithm>
 #include <cstdint>
+#include <limits>
+#include <numeric>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Gcd", "[Gcd]") {
   REQUIRE(Gcd(1, 1) == 1);
@@ -27,3 +49,817 @@ TEST_CASE("ReturnTypeMatchesTemplateParameter", "[Gcd]") {
   static_assert(std::is_same_v<SignedType, int16_t>, "Gcd<int16_t> must return int16_t");
   static_assert(std::is_same_v<UnsignedType, uint64_t>, "Gcd<uint64_t> must return uint64_t");
 }
+
+TEST_CASE("Zero", "[Gcd]") {
+  REQUIRE(Gcd(0, 0) == 0);
+  REQUIRE(Gcd(0, 12) == 12);
+  REQUIRE(Gcd<uint8_t>(200, 0) == 200);
+  REQUIRE(Gcd<int64_t>(0, std::numeric_limits<int64_t>::max()) == std::numeric_limits<int64_t>::max());
+}
+
+TEST_CASE("Constexpr", "[Gcd]") {
+  static_assert(Gcd(48, 180) == 12);
+  static_assert(Gcd<uint64_t>(uint64_t{1} << 63, uint64_t{3} << 40) == uint64_t{1} << 40);
+  static_assert(Gcd<int8_t>(126, 84) == 42);
+  static_assert(Gcd<uint16_t>(65535, 4369) == 4369);
+}
+
+TEST_CASE("PowersOfTwo", "[Gcd]") {
+  REQUIRE(Gcd<uint64_t>(std::numeric_limits<uint64_t>::max() - 1, uint64_t{1} << 63) == 2);
+  REQUIRE(Gcd<uint32_t>(uint32_t{3} << 20, uint32_t{5} << 25) == uint32_t{1} << 20);
+  REQUIRE(Gcd<uint8_t>(128, 192) == 64);
+}
+
+TEST_CASE("Fibonacci", "[Gcd]") {
+  uint64_t previous = 1;
+  uint64_t current = 1;
+  while (current <= std::numeric_limits<uint64_t>::max() - previous) {
+    REQUIRE(Gcd(previous, current) == 1);
+    if (current <= std::numeric_limits<uint64_t>::max() / 3) {
+      REQUIRE(Gcd(current * 3, previous * 3) == 3);
+    }
+    previous = std::exchange(current, current + previous);
+  }
+}
+
+template <class T>
+void CheckRandom(std::mt19937_64& gen) {
+  std::uniform_int_distribution<uint64_t> dist(0, static_cast<uint64_t>(std::numeric_limits<T>::max()));
+  for (int i = 0; i < 10000; ++i) {
+    const auto common = static_cast<T>(dist(gen) % 64 + 1);
+    const auto x = static_cast<T>(dist(gen) / common * common);
+    const auto y = static_cast<T>(dist(gen) / common * common);
+    REQUIRE(Gcd<T>(x, y) == std::gcd(x, y));
+  }
+}
+
+TEST_CASE("MatchesStdGcd", "[Gcd]") {
+  std::mt19937_64 gen(1);
+  CheckRandom<int8_t>(gen);
+  CheckRandom<uint8_t>(gen);
+  CheckRandom<int16_t>(gen);
+  CheckRandom<int>(gen);
+  CheckRandom<uint32_t>(gen);
+  CheckRandom<long long>(gen);
+  CheckRandom<uint64_t>(gen);
+}
+
+TEST_CASE("SmallTable", "[Gcd]") {
+  static_assert(gcd_internal::kGcdSmallTable.size() == kGcdSmallTableSize * kGcdSmallTableSize);
+  // Both sides of the table's edge, for operand types narrower and wider than the table index.
+  for (int x = 0; x < 2 * static_cast<int>(kGcdSmallTableSize) + 3; ++x) {
+    for (int y = 0; y < 2 * static_cast<int>(kGcdSmallTableSize) + 3; ++y) {
+      REQUIRE(Gcd(x, y) == std::gcd(x, y));
+      REQUIRE(Gcd<uint8_t>(x, y) == std::gcd<uint8_t>(x, y));
+      REQUIRE(Gcd<int64_t>(x, y) == std::gcd(x, y));
+    }
+  }
+}
+
+template <class T>
+void CheckMany(std::mt19937_64& gen, size_t size) {
+  std::uniform_int_distribution<uint64_t> dist(0, static_cast<uint64_t>(std::numeric_limits<T>::max()));
+  std::vector<T> a(size);
+  std::vector<T> b(size);
+  for (size_t i = 0; i < size; ++i) {
+    const auto common = static_cast<T>(dist(gen) % 8 + 1);
+    a[i] = i % 13 == 0 ? 0 : static_cast<T>(dist(gen) / common * common);
+    b[i] = i % 17 == 0 ? 0 : static_cast<T>(dist(gen) / common * common);
+  }
+  std::vector<T> out(size);
+  GcdMany<T>(a, b, out);
+  for (size_t i = 0; i < size; ++i) {
+    REQUIRE(out[i] == Gcd(a[i], b[i]));
+  }
+}
+
+TEST_CASE("GcdMany", "[GcdMany]") {
+  std::mt19937_64 gen(2);
+  for (size_t size : {0, 1, 7, 16, 1001}) {
+    CheckMany<int8_t>(gen, size);
+    CheckMany<uint16_t>(gen, size);
+    CheckMany<int>(gen, size);
+    CheckMany<uint64_t>(gen, size);
+  }
+
+  const std::vector<uint32_t> a{0, 0, 5, 12, 4294967295U};
+  const std::vector<uint32_t> b{0, 7, 0, 18, 4294967295U};
+  std::vector<uint32_t> out(a.size());
+  GcdMany<uint32_t>(a, b, out);
+  REQUIRE(out == std::vector<uint32_t>{0, 7, 5, 6, 4294967295U});
+
+  std::vector<uint32_t> short_out(2);
+  REQUIRE_THROWS_AS(GcdMany<uint32_t>(a, b, short_out), GcdSizeMismatch);
+}
+
+TEST_CASE("GcdReduce", "[GcdReduce]") {
+  REQUIRE(GcdReduce<int>({}) == 0);
+  REQUIRE(GcdReduce<int>(std::vector<int>{0, 0}) == 0);
+  REQUIRE(GcdReduce<int>(std::vector<int>{0, 12, 0, 18, 30}) == 6);
+  REQUIRE(GcdReduce<uint64_t>(std::vector<uint64_t>{7}) == 7);
+
+  std::mt19937_64 gen(3);
+  std::uniform_int_distribution<uint64_t> dist(1, uint64_t{1} << 40);
+  std::vector<uint64_t> values(5 * kGcdReduceGrain + 17);
+  for (auto& value : values) {
+    value = dist(gen) * 360;
+  }
+  for (size_t num_threads : {1, 2, 4, 0}) {
+    REQUIRE(GcdReduce<uint64_t>(values, num_threads) == std::accumulate(values.begin(), values.end(), uint64_t{0},
+                                                                         [](uint64_t x, uint64_t y) {
+                                                                           return std::gcd(x, y);
+                                                                         }));
+  }
+
+  // A single coprime element anywhere ends the reduction with 1.
+  for (size_t position : {size_t{0}, kGcdReduceGrain - 1, 3 * kGcdReduceGrain + 5, values.size() - 1}) {
+    auto copy = values;
+    copy[position] = 7;
+    copy[position / 2] = 11;
+    for (size_t num_threads : {1, 3}) {
+      REQUIRE(GcdReduce<uint64_t>(copy, num_threads) == 1);
+    }
+  }
+}
+
+#ifdef __SIZEOF_INT128__
+__extension__ using Int128 = __int128;
+__extension__ using Uint128 = unsigned __int128;
+#endif
+
+TEST_CASE("AllPairsGcd", "[AllPairsGcd]") {
+  REQUIRE(AllPairsGcd<int>({}).empty());
+  REQUIRE(AllPairsGcd<int>(std::vector<int>{4, 6, 0}) == std::vector<int>{4, 2, 4, 2, 6, 6, 4, 6, 0});
+
+  std::mt19937_64 gen(5);
+  std::vector<uint32_t> values(2 * kAllPairsGcdTile + 17);
+  for (auto& value : values) {
+    value = static_cast<uint32_t>(gen() % 1000 * (gen() % 12 + 1));
+  }
+  const auto size = values.size();
+  for (size_t num_threads : {1, 3, 0}) {
+    const auto matrix = AllPairsGcd<uint32_t>(values, num_threads);
+    for (size_t i = 0; i < size; ++i) {
+      for (size_t j = 0; j < size; ++j) {
+        REQUIRE(matrix[i * size + j] == std::gcd(values[i], values[j]));
+      }
+    }
+  }
+
+  // Each pair above the diagonal arrives exactly once.
+  std::vector<int> seen(size * size);
+  ForEachAllPairsGcdTile<uint32_t>(
+      values,
+      [&](const AllPairsGcdTile<uint32_t>& tile) {
+        REQUIRE(tile.gcds.size() == tile.num_rows * tile.num_columns);
+        for (size_t i = 0; i < tile.num_rows; ++i) {
+          for (size_t j = 0; j < tile.num_columns; ++j) {
+            ++seen[(tile.row_begin + i) * size + tile.column_begin + j];
+          }
+        }
+      },
+      2);
+  for (size_t i = 0; i < size; ++i) {
+    for (size_t j = i + 1; j < size; ++j) {
+      REQUIRE(seen[i * size + j] == 1);
+    }
+  }
+}
+
+// Textbook extended Euclid with cofactors modulo 2^bits, the reference for the Lehmer path.
+template <class U>
+std::pair<U, U> ReferenceCofactors(U a, U b) {
+  U x0 = 1;
+  U x1 = 0;
+  U y0 = 0;
+  U y1 = 1;
+  while (b != 0) {
+    const U q = a / b;
+    x0 = static_cast<U>(x0 - q * x1);
+    y0 = static_cast<U>(y0 - q * y1);
+    std::swap(x0, x1);
+    std::swap(y0, y1);
+    a = static_cast<U>(a - q * b);
+    std::swap(a, b);
+  }
+  return {x0, y0};
+}
+
+template <class U>
+void CheckExtendedGcd(U a, U b) {
+  const auto [g, x, y] = ExtendedGcd(a, b);
+  REQUIRE(g == Gcd(a, b));
+  const auto [reference_x, reference_y] = ReferenceCofactors(a, b);
+  REQUIRE(static_cast<U>(x) == reference_x);
+  REQUIRE(static_cast<U>(y) == reference_y);
+#ifdef __SIZEOF_INT128__
+  if constexpr (sizeof(U) <= sizeof(uint64_t)) {
+    REQUIRE(Int128{a} * x + Int128{b} * y == Int128{g});
+  }
+#endif
+  REQUIRE(static_cast<U>(static_cast<U>(a * static_cast<U>(x)) + static_cast<U>(b * static_cast<U>(y))) == g);
+}
+
+TEST_CASE("ExtendedGcd", "[ExtendedGcd]") {
+  static_assert(ExtendedGcd(240, 46) == ExtendedGcdResult<int>{2, -9, 47});
+  static_assert(ExtendedGcd<uint64_t>(0, 0) == ExtendedGcdResult<uint64_t>{0, 1, 0});
+  REQUIRE(ExtendedGcd<uint32_t>(5, 0) == ExtendedGcdResult<uint32_t>{5, 1, 0});
+  REQUIRE(ExtendedGcd<uint32_t>(0, 5) == ExtendedGcdResult<uint32_t>{5, 0, 1});
+  REQUIRE(ExtendedGcd<int64_t>(6, 6) == ExtendedGcdResult<int64_t>{6, 0, 1});
+  REQUIRE(ExtendedGcd<uint64_t>(12, 18) == ExtendedGcdResult<uint64_t>{6, -1, 1});
+
+  std::mt19937_64 gen(4);
+  for (int i = 0; i < 20000; ++i) {
+    const auto a = gen();
+    const auto b = gen() >> (i % 64);
+    CheckExtendedGcd<uint32_t>(static_cast<uint32_t>(a), static_cast<uint32_t>(b));
+    CheckExtendedGcd<uint64_t>(a, b);
+    CheckExtendedGcd<uint64_t>(b, a);
+#ifdef __SIZEOF_INT128__
+    CheckExtendedGcd<Uint128>(Uint128{a} << 64 | gen(), Uint128{b} << (i % 64) | gen());
+    CheckExtendedGcd<Uint128>(Uint128{a} << 64 | b, gen());
+#endif
+  }
+  // Consecutive Fibonacci numbers: all quotients are 1 and the coefficients reach their bounds.
+  uint64_t previous = 1;
+  uint64_t current = 1;
+  while (current <= std::numeric_limits<uint64_t>::max() - previous) {
+    std::swap(previous, current);
+    current += previous;
+    CheckExtendedGcd(current, previous);
+  }
+#ifdef __SIZEOF_INT128__
+  Uint128 previous_wide = 1;
+  Uint128 current_wide = 1;
+  while (current_wide <= ~Uint128{0} - previous_wide) {
+    std::swap(previous_wide, current_wide);
+    current_wide += previous_wide;
+    CheckExtendedGcd(current_wide, previous_wide);
+  }
+#endif
+}
+
+TEST_CASE("ModInverse", "[ModInverse]") {
+  static_assert(ModInverse(3, 7) == 5);
+  REQUIRE(ModInverse(10, 7) == 5);
+  REQUIRE(ModInverse(0, 1) == 0);
+  REQUIRE(ModInverse(5, 1) == 0);
+  REQUIRE(ModInverse(4, 6) == std::nullopt);
+  REQUIRE(ModInverse(0, 7) == std::nullopt);
+  REQUIRE(ModInverse(3, 0) == std::nullopt);
+
+  std::mt19937_64 gen(5);
+  for (const uint64_t modulus : {uint64_t{998244353}, uint64_t{1000000007}, uint64_t{18446744073709551557u}}) {
+    for (int i = 0; i < 1000; ++i) {
+      const uint64_t a = gen() % (modulus - 1) + 1;
+      const auto inverse = ModInverse(a, modulus);
+      REQUIRE(inverse.has_value());
+      REQUIRE(*inverse < modulus);
+#ifdef __SIZEOF_INT128__
+      REQUIRE(Uint128{a} * *inverse % modulus == 1);
+#endif
+    }
+  }
+  for (int i = 0; i < 1000; ++i) {
+    const auto a = static_cast<uint32_t>(gen());
+    const auto modulus = static_cast<uint32_t>(gen()) | 1;
+    const auto inverse = ModInverse(a, modulus);
+    REQUIRE(inverse.has_value() == (Gcd(a, modulus) == 1));
+    if (inverse) {
+      REQUIRE(uint64_t{a} * *inverse % modulus == 1);
+    }
+  }
+}
+
+TEST_CASE("Lcm", "[Lcm]") {
+  static_assert(Lcm(4, 6) == 12);
+  REQUIRE(Lcm(0, 6) == 0);
+  REQUIRE(Lcm(6, 0) == 0);
+  REQUIRE(Lcm<uint32_t>(1, 1) == 1);
+  REQUIRE(Lcm<uint32_t>(65536, 65535) == uint32_t{4294901760u});
+  REQUIRE(Lcm<uint32_t>(65536, 65537) == std::nullopt);
+  REQUIRE(Lcm<int8_t>(16, 8) == 16);
+  REQUIRE(Lcm<int8_t>(16, 9) == std::nullopt);
+  REQUIRE(Lcm<int64_t>(std::numeric_limits<int64_t>::max(), 1) == std::numeric_limits<int64_t>::max());
+  // Dividing first keeps the product of large operands with a large common factor in range.
+  REQUIRE(Lcm<uint64_t>(uint64_t{3} << 61, uint64_t{1} << 62) == uint64_t{3} << 62);
+
+  std::mt19937_64 gen(6);
+  for (int i = 0; i < 10000; ++i) {
+    const auto a = static_cast<uint32_t>(gen() >> (i % 32));
+    const auto b = static_cast<uint32_t>(gen() >> (i % 31));
+    const auto expected = a == 0 || b == 0 ? 0 : uint64_t{a} / Gcd(a, b) * b;
+    const auto lcm = Lcm(a, b);
+    REQUIRE(lcm.has_value() == (expected <= std::numeric_limits<uint32_t>::max()));
+    if (lcm) {
+      REQUIRE(*lcm == expected);
+    }
+  }
+}
+
+TEST_CASE("LcmReduce", "[LcmReduce]") {
+  REQUIRE(LcmReduce<uint32_t>({}) == 1);
+  REQUIRE(LcmReduce<int>(std::vector<int>{4, 6, 10}) == 60);
+  static_assert(std::is_same_v<decltype(LcmReduce<int>({}))::value_type, int64_t>);
+
+  // 1..40: the Lcm exceeds 32 bits after 23 and 64 bits never.
+  std::vector<uint32_t> values(40);
+  std::iota(values.begin(), values.end(), 1);
+  uint64_t expected = 1;
+  for (const auto value : values) {
+    expected = expected / std::gcd(expected, uint64_t{value}) * value;
+  }
+  REQUIRE(LcmReduce<uint32_t>(values) == expected);
+  values.push_back(0);
+  REQUIRE(LcmReduce<uint32_t>(values) == 0);
+
+#ifdef __SIZEOF_INT128__
+  const std::vector<uint64_t> primes{18446744073709551557u, 18446744073709551533u};
+  REQUIRE(LcmReduce<uint64_t>(primes) == Uint128{primes[0]} * primes[1]);
+  const std::vector<Uint128> wide{~Uint128{0}, 2};
+  REQUIRE(LcmReduce<Uint128>(wide) == std::nullopt);
+  REQUIRE(LcmReduce<Uint128>(std::vector<Uint128>{~Uint128{0}, 2, 0}) == Uint128{0});
+#endif
+}
+
+// Limbs that are mostly 0, 1, all ones or the top bit: the corner cases of carries and quotient estimates.
+BigUint RandomBigUint(std::mt19937_64& gen, size_t max_limbs) {
+  std::vector<uint64_t> limbs(gen() % max_limbs + 1);
+  for (auto& limb : limbs) {
+    const uint64_t special[] = {0, 1, ~uint64_t{0}, ~uint64_t{0} - 1, uint64_t{1} << 63, gen()};
+    limb = special[gen() % 6];
+  }
+  limbs.back() |= gen() % 2;
+  return BigUint(limbs);
+}
+
+BigUint EuclidGcd(BigUint a, BigUint b) {
+  while (!b.IsZero()) {
+    a %= b;
+    std::swap(a, b);
+  }
+  return a;
+}
+
+TEST_CASE("BigUint", "[BigUint]") {
+  REQUIRE(BigUint().IsZero());
+  REQUIRE(BigUint().ToString() == "0");
+  REQUIRE(BigUint(0) == BigUint());
+  const BigUint googol("1" + std::string(100, '0'));
+  REQUIRE(googol.ToString() == "1" + std::string(100, '0'));
+  REQUIRE(googol == BigUint("10000000000") * BigUint("1" + std::string(90, '0')));
+  REQUIRE(BigUint("00012").ToString() == "12");
+  REQUIRE(BigUint(std::numeric_limits<uint64_t>::max()).ToString() == "18446744073709551615");
+  REQUIRE((BigUint(std::numeric_limits<uint64_t>::max()) + BigUint(1)).ToString() == "18446744073709551616");
+  REQUIRE(googol.BitWidth() == 333);
+  REQUIRE_THROWS_AS(BigUint(""), BigUintInvalidString);
+  REQUIRE_THROWS_AS(BigUint("12a"), BigUintInvalidString);
+  REQUIRE_THROWS_AS(BigUint(1) - BigUint(2), BigUintUnderflow);
+  REQUIRE_THROWS_AS(googol / BigUint(), BigUintDivisionByZero);
+
+  std::stringstream stream("123456789012345678901234567890 x");
+  BigUint read;
+  REQUIRE(stream >> read);
+  REQUIRE(read == BigUint("123456789012345678901234567890"));
+  REQUIRE_FALSE(stream >> read);
+  std::stringstream out;
+  out << googol;
+  REQUIRE(out.str() == googol.ToString());
+
+#ifdef __SIZEOF_INT128__
+  std::mt19937_64 gen(7);
+  const auto to_wide = [](const BigUint& value) {
+    return Uint128{value.Limb(1)} << 64 | value.Limb(0);
+  };
+  for (int i = 0; i < 10000; ++i) {
+    const auto x = Uint128{gen()} << 64 | gen();
+    const auto y = (Uint128{gen()} << 64 | gen()) >> (i % 128);
+    const BigUint big_x(std::vector<uint64_t>{static_cast<uint64_t>(x), static_cast<uint64_t>(x >> 64)});
+    const BigUint big_y(std::vector<uint64_t>{static_cast<uint64_t>(y), static_cast<uint64_t>(y >> 64)});
+    REQUIRE(to_wide(big_x + big_y) == x + y);
+    if (x >= y) {
+      REQUIRE(to_wide(big_x - big_y) == x - y);
+    }
+    REQUIRE(to_wide(BigUint(static_cast<uint64_t>(x)) * BigUint(static_cast<uint64_t>(y))) ==
+            Uint128{static_cast<uint64_t>(x)} * static_cast<uint64_t>(y));
+    REQUIRE(to_wide(big_x >> (i % 130)) == (i % 130 < 128 ? x >> (i % 130) : 0));
+    REQUIRE(to_wide(big_y << (i % 64)) == y << (i % 64));
+    if (y != 0) {
+      REQUIRE(to_wide(big_x / big_y) == x / y);
+      REQUIRE(to_wide(big_x % big_y) == x % y);
+    }
+  }
+
+  for (int i = 0; i < 3000; ++i) {
+    const auto a = RandomBigUint(gen, 12);
+    auto b = RandomBigUint(gen, 8);
+    if (b.IsZero()) {
+      b = BigUint(1);
+    }
+    const auto c = RandomBigUint(gen, 8) % b;
+    const auto n = a * b + c;
+    const auto [quotient, remainder] = BigUint::DivMod(n, b);
+    REQUIRE(quotient == a);
+    REQUIRE(remainder == c);
+    REQUIRE(n - c == a * b);
+    REQUIRE(BigUint(n.ToString()) == n);
+    REQUIRE(((n << 100) >> 100) == n);
+  }
+#endif
+}
+
+TEST_CASE("BigUintLong", "[BigUint]") {
+  // Operands long enough for Karatsuba's multiplication and the Newton division, checked against the products with
+  // single limbs and against the identity a = (a / b) b + a % b.
+  std::mt19937_64 gen(11);
+  for (int i = 0; i < 60; ++i) {
+    const auto a = RandomBigUint(gen, 400);
+    const auto b = RandomBigUint(gen, 300);
+    BigUint expected;
+    for (size_t j = b.Limbs().size(); j-- > 0;) {
+      expected = (expected << 64) + a * BigUint(b.Limb(j));
+    }
+    REQUIRE(a * b == expected);
+    REQUIRE(b * a == expected);
+
+    auto divisor = RandomBigUint(gen, 200);
+    if (divisor.IsZero()) {
+      divisor = BigUint(1);
+    }
+    const auto rest = b % divisor;
+    const auto [quotient, remainder] = BigUint::DivMod(expected + rest, divisor);
+    REQUIRE(remainder < divisor);
+    REQUIRE(quotient * divisor + remainder == expected + rest);
+    if (!b.IsZero()) {
+      const auto small = divisor % b;
+      REQUIRE(BigUint::DivMod(expected + small, b) == std::pair(a, small));
+    }
+  }
+  std::vector<uint64_t> limbs(4200);
+  for (auto& limb : limbs) {
+    limb = gen();
+  }
+  const auto a = BigUint(std::span<const uint64_t>(limbs).first(2100));
+  const auto b = BigUint(std::span<const uint64_t>(limbs).last(2100));
+  const auto c = (a >> 64 * 1000) + (b >> 64 * 1000);
+  REQUIRE(BigUint::DivMod(a * b + c, b) == std::pair(a, c));
+  REQUIRE(BigUint::DivMod(a * b + c, a) == std::pair(b, c));
+  const auto ones = (BigUint(1) << 64 * 300) - BigUint(1);
+  REQUIRE(ones * ones == (BigUint(1) << 64 * 600) - (BigUint(1) << (64 * 300 + 1)) + BigUint(1));
+  REQUIRE((ones * ones) / ones == ones);
+  REQUIRE((ones * ones + ones - BigUint(1)) % ones == ones - BigUint(1));
+}
+
+template <class X, class Y>
+concept HasGcd = requires(X x, Y y) { Gcd(x, y); };
+
+template <class X, class Y>
+concept HasLcm = requires(X x, Y y) { Lcm(x, y); };
+
+TEST_CASE("GcdBigUint", "[Gcd]") {
+  // Integers of different types do not convert to BigUint behind the caller's back.
+  static_assert(!std::is_convertible_v<uint64_t, BigUint>);
+  static_assert(!HasGcd<int, uint64_t>);
+  static_assert(!HasLcm<int, uint64_t>);
+  static_assert(HasGcd<BigUint, BigUint>);
+  static_assert(std::is_same_v<decltype(Gcd(uint64_t{12}, uint64_t{18})), uint64_t>);
+  REQUIRE(Gcd(BigUint(), BigUint()) == BigUint());
+  REQUIRE(Gcd(BigUint("123456789012345678901234567890"), BigUint()) == BigUint("123456789012345678901234567890"));
+  REQUIRE(Gcd(BigUint(12), BigUint(18)) == BigUint(6));
+
+  // Consecutive Fibonacci numbers of about 3000 bits.
+  BigUint previous(1);
+  BigUint current(1);
+  for (int i = 0; i < 4300; ++i) {
+    previous += current;
+    std::swap(previous, current);
+  }
+  REQUIRE(current.BitWidth() > 2900);
+  REQUIRE(Gcd(current, previous) == BigUint(1));
+  const BigUint factor("98765432109876543210987654321");
+  REQUIRE(Gcd(current * factor, previous * factor) == factor);
+
+  std::mt19937_64 gen(8);
+  for (int i = 0; i < 300; ++i) {
+    const auto common = RandomBigUint(gen, 4);
+    const auto a = RandomBigUint(gen, 64) * common;
+    const auto b = RandomBigUint(gen, 64) * common;
+    REQUIRE(Gcd(a, b) == EuclidGcd(a, b));
+  }
+}
+
+// Gcd of each value with the product of all others from prefix and suffix products.
+template <class T>
+std::vector<BigUint> ReferenceBatchGcd(const std::vector<T>& values) {
+  std::vector<BigUint> suffix(values.size() + 1, BigUint(1));
+  for (size_t i = values.size(); i-- > 0;) {
+    suffix[i] = suffix[i + 1] * BigUint(values[i]);
+  }
+  std::vector<BigUint> gcds;
+  BigUint prefix(1);
+  for (size_t i = 0; i < values.size(); ++i) {
+    gcds.push_back(Gcd(BigUint(values[i]), prefix * suffix[i + 1]));
+    prefix *= BigUint(values[i]);
+  }
+  return gcds;
+}
+
+TEST_CASE("BatchGcd", "[BatchGcd]") {
+  REQUIRE(BatchGcd(std::vector<uint64_t>{}).empty());
+  REQUIRE(BatchGcd(std::vector<uint64_t>{35}) == std::vector<uint64_t>{1});
+  REQUIRE(BatchGcd(std::vector<uint64_t>{6, 10, 15, 7}) == std::vector<uint64_t>{6, 10, 15, 1});
+  REQUIRE_THROWS_AS(BatchGcd(std::vector<uint64_t>{3, 0}), BatchGcdZeroValue);
+
+  // Products of two random odd 32-bit factors out of a pool small enough for some of them to share one, like RSA
+  // moduli generated with a weak random source.
+  std::mt19937_64 gen(12);
+  std::vector<uint64_t> factors(600);
+  for (auto& factor : factors) {
+    factor = (gen() >> 32) | 1;
+  }
+  std::vector<uint64_t> moduli(400);
+  for (auto& modulus : moduli) {
+    modulus = factors[gen() % factors.size()] * factors[gen() % factors.size()];
+  }
+  std::vector<uint64_t> expected;
+  for (const auto& gcd : ReferenceBatchGcd(moduli)) {
+    expected.push_back(gcd.Limb(0));
+  }
+  REQUIRE(std::count(expected.begin(), expected.end(), 1) < 400);
+  for (size_t num_threads : {1, 2, 3, 0}) {
+    REQUIRE(BatchGcd(moduli, num_threads) == expected);
+  }
+
+  std::vector<BigUint> values;
+  for (int i = 0; i < 150; ++i) {
+    values.push_back(RandomBigUint(gen, 6) * BigUint(factors[gen() % 100]) + BigUint(1));
+  }
+  const auto big_expected = ReferenceBatchGcd(values);
+  REQUIRE(BatchGcd(values, 4) == big_expected);
+  std::vector<int> calls(values.size());
+  ForEachBatchGcd(
+      std::span<const BigUint>(values),
+      [&](size_t index, const BigUint& gcd) {
+        ++calls[index];
+        REQUIRE(gcd == big_expected[index]);
+      },
+      2);
+  REQUIRE(std::all_of(calls.begin(), calls.end(), [](int count) {
+    return count == 1;
+  }));
+}
+
+template <class T>
+void CheckFactorize(T n) {
+  const auto factors = Factorize(n);
+  REQUIRE(std::is_sorted(factors.begin(), factors.end()));
+  T product = 1;
+  for (const auto factor : factors) {
+    REQUIRE(IsPrime(factor));
+    product *= factor;
+  }
+  REQUIRE(product == n);
+}
+
+TEST_CASE("IsPrime", "[Factorize]") {
+  static_assert(gcd_internal::kSmallPrimes.size() == 172);
+  static_assert(gcd_internal::kSmallPrimes.back() == 1021);
+  std::vector<bool> composite(200000);
+  for (size_t i = 2; i < composite.size(); ++i) {
+    for (auto j = 2 * i; j < composite.size() && !composite[i]; j += i) {
+      composite[j] = true;
+    }
+    REQUIRE(IsPrime<uint64_t>(i) == !composite[i]);
+  }
+  REQUIRE_FALSE(IsPrime<uint32_t>(0));
+  REQUIRE_FALSE(IsPrime<uint8_t>(1));
+  REQUIRE(IsPrime<uint8_t>(251));
+  REQUIRE(IsPrime<uint64_t>((uint64_t{1} << 61) - 1));
+  REQUIRE(IsPrime<uint64_t>(18446744073709551557u));
+  // Strong pseudoprimes to the bases 2 to 7, to the primes up to 23 and, past 2^64, up to 37.
+  REQUIRE_FALSE(IsPrime<uint64_t>(3215031751));
+  REQUIRE_FALSE(IsPrime<uint64_t>(3825123056546413051));
+#ifdef __SIZEOF_INT128__
+  REQUIRE(IsPrime((Uint128{1} << 127) - 1));
+  REQUIRE(IsPrime((Uint128{1} << 89) - 1));
+  REQUIRE_FALSE(IsPrime(Uint128{318665857834031151} * 1000000 + 167461));
+  REQUIRE_FALSE(IsPrime(Uint128{18446744073709551557u} * 18446744073709551557u));
+#endif
+}
+
+TEST_CASE("Factorize", "[Factorize]") {
+  REQUIRE(Factorize<uint64_t>(1).empty());
+  REQUIRE(Factorize<uint8_t>(255) == std::vector<uint8_t>{3, 5, 17});
+  REQUIRE(Factorize<uint32_t>(1u << 31) == std::vector<uint32_t>(31, 2));
+  REQUIRE(Factorize<uint64_t>(18446744073709551557u) == std::vector<uint64_t>{18446744073709551557u});
+  REQUIRE(Factorize<uint64_t>(uint64_t{4294967291} * 4294967279) == std::vector<uint64_t>{4294967279, 4294967291});
+  REQUIRE(Factorize<uint64_t>(uint64_t{1031} * 1031 * 1033) == std::vector<uint64_t>{1031, 1031, 1033});
+  REQUIRE_THROWS_AS(Factorize<uint16_t>(0), FactorizeZero);
+
+  std::mt19937_64 gen(13);
+  std::vector<uint64_t> values;
+  for (int i = 0; i < 200; ++i) {
+    values.push_back(gen() | 1);
+    values.push_back((gen() >> 32 | 1) * (gen() >> 40 | 1));
+  }
+  for (const auto value : values) {
+    CheckFactorize(value);
+  }
+  const auto many = FactorizeMany<uint64_t>(values, 3);
+  for (size_t i = 0; i < values.size(); ++i) {
+    REQUIRE(many[i] == Factorize(values[i]));
+  }
+
+#ifdef __SIZEOF_INT128__
+  // A 128-bit number with a 36-bit and a 64-bit prime factor, and random ones whose second largest prime factor has at
+  // most 34 bits.
+  Uint128 prime = Uint128{1} << 36;
+  while (!IsPrime(prime)) {
+    ++prime;
+  }
+  REQUIRE(Factorize(prime * 18446744073709551557u * 3) ==
+          std::vector<Uint128>{3, prime, Uint128{18446744073709551557u}});
+  for (int i = 0; i < 20; ++i) {
+    CheckFactorize(Uint128{gen() >> 30} * gen());
+  }
+#endif
+}
+
+TEST_CASE("Polynomial", "[Polynomial]") {
+  using P = Polynomial<int64_t>;
+  REQUIRE(P().Degree() == -1);
+  REQUIRE(P{3, 0, 0}.Degree() == 0);
+  REQUIRE(P{1, 1} * P{-1, 1} == P{-1, 0, 1});
+  REQUIRE(P{1, 2} + P{0, -2} == P(1));
+  REQUIRE(P{-4, 0, 6}.Content() == 2);
+  REQUIRE(P{4, -6}.Content() == -2);
+  REQUIRE(P{4, -6}.PrimitivePart() == P{-2, 3});
+  REQUIRE(gcd_internal::PseudoRemainder(P{1, 0, 1}, P{1, 2}) == P(5));
+  // 8 (x^4 + 1) mod (2 x^2 + 1): the x^3 step is skipped and its factor 2 applied at the end.
+  REQUIRE(gcd_internal::PseudoRemainder(P{1, 0, 0, 0, 1}, P{1, 0, 2}) == P(10));
+  REQUIRE(gcd_internal::PseudoRemainder(P{0, 0, 1, 0, 2}, P{1, 0, 2}).IsZero());
+  // No room for lc(b)^3 = 64^3 in int16_t, but the remainder is 0 after the first step.
+  REQUIRE(gcd_internal::PseudoRemainder(Polynomial<int16_t>{0, 0, 1, 0, 64}, Polynomial<int16_t>{1, 0, 64}).IsZero());
+  REQUIRE_THROWS_AS((Polynomial<int8_t>{100} * Polynomial<int8_t>{0, 100}), PolynomialOverflow);
+  REQUIRE_THROWS_AS(-Polynomial<int8_t>{-128}, PolynomialOverflow);
+}
+
+TEST_CASE("GcdPolynomial", "[Polynomial]") {
+  using P = Polynomial<int64_t>;
+  REQUIRE(Gcd(P(), P()) == P());
+  REQUIRE(Gcd(P{0, -2}, P()) == P{0, 2});
+  REQUIRE(Gcd(P(12), P(18)) == P(6));
+  REQUIRE(Gcd(P{4, 6}, P(10)) == P(2));
+  const P factor = P{5, 3} * P{1, 1};
+  REQUIRE(Gcd(factor * P{-2, 1} * P(6), factor * P{1, 0, 1} * P(-4)) == factor * P(2));
+
+  // Knuth's example, whose plain Euclidean remainders reach coefficients with dozens of digits.
+  const P a{-5, 2, 8, -3, -3, 0, 1, 0, 1};
+  const P b{21, -9, -4, 0, 5, 0, 3};
+  REQUIRE(Gcd(a, b) == P(1));
+#ifdef __SIZEOF_INT128__
+  using WideP = Polynomial<Int128>;
+  const WideP wide_a{-5, 2, 8, -3, -3, 0, 1, 0, 1};
+  const WideP wide_b{21, -9, -4, 0, 5, 0, 3};
+  REQUIRE(Gcd(wide_a * WideP{-1, 0, 2}, wide_b * WideP{-1, 0, 2}) == WideP{-1, 0, 2});
+#endif
+
+  // Random products of small factors share exactly their common factor when the rest is coprime.
+  std::mt19937_64 gen(14);
+  const auto random_polynomial = [&](int degree) {
+    std::vector<int64_t> coefficients;
+    for (int i = 0; i <= degree; ++i) {
+      coefficients.push_back(static_cast<int64_t>(gen() % 7) - 3);
+    }
+    coefficients.back() = static_cast<int64_t>(gen() % 3) + 1;
+    return P(coefficients);
+  };
+  for (int i = 0; i < 200; ++i) {
+    const auto common = random_polynomial(static_cast<int>(gen() % 3)).PrimitivePart();
+    const auto x = random_polynomial(static_cast<int>(gen() % 3) + 1);
+    const auto y = random_polynomial(static_cast<int>(gen() % 3) + 1);
+    const auto gcd = Gcd(common * x, common * y);
+    REQUIRE(gcd.Leading() > 0);
+    REQUIRE(gcd_internal::PseudoRemainder(common * x, gcd).IsZero());
+    REQUIRE(gcd_internal::PseudoRemainder(common * y, gcd).IsZero());
+    REQUIRE(gcd_internal::PseudoRemainder(gcd, common).IsZero());
+    if (Gcd(x, y).Degree() == 0) {
+      REQUIRE(gcd == common * Gcd(x, y));
+    }
+  }
+}
+
+TEST_CASE("ModRing", "[ModInt]") {
+  REQUIRE_THROWS_AS(ModRing(0), ModIntInvalidModulus);
+  REQUIRE_THROWS_AS(ModRing(1), ModIntInvalidModulus);
+
+  // Odd moduli take Montgomery reduction, even ones Barrett below 2^32 and a division above.
+  std::mt19937_64 gen(15);
+  for (const uint64_t modulus : {uint64_t{2}, uint64_t{3}, uint64_t{1000}, uint64_t{998244353}, uint64_t{4294967294u},
+                                 uint64_t{4294967295u}, uint64_t{4294967296u}, (uint64_t{1} << 61) - 1,
+                                 uint64_t{18446744073709551557u}, uint64_t{18446744073709551614u},
+                                 std::numeric_limits<uint64_t>::max()}) {
+    const ModRing ring(modulus);
+    REQUIRE(ring.Modulus() == modulus);
+    REQUIRE(ring.From(ring.One()) == 1);
+    REQUIRE(ring.From(ring.To(modulus)) == 0);
+    for (int i = 0; i < 1000; ++i) {
+      const auto a = i < 2 ? modulus - 1 : gen() % modulus;
+      const auto b = gen() % modulus;
+      const auto x = ring.To(a);
+      const auto y = ring.To(b);
+      REQUIRE(ring.From(x) == a);
+      REQUIRE(ring.From(ring.Add(x, y)) == (a >= modulus - b ? a - (modulus - b) : a + b));
+      REQUIRE(ring.From(ring.Sub(x, y)) == (a >= b ? a - b : a + (modulus - b)));
+#ifdef __SIZEOF_INT128__
+      REQUIRE(ring.From(ring.Mul(x, y)) == static_cast<uint64_t>(Uint128{a} * b % modulus));
+      const auto exponent = gen() % 100;
+      Uint128 power = 1 % modulus;
+      for (uint64_t j = 0; j < exponent; ++j) {
+        power = power * a % modulus;
+      }
+      REQUIRE(ring.From(ring.Pow(x, exponent)) == static_cast<uint64_t>(power));
+#endif
+      const auto inverse = ring.Inverse(x);
+      REQUIRE(inverse.has_value() == (Gcd(a, modulus) == 1));
+      if (inverse) {
+        REQUIRE(ring.From(ring.Mul(x, *inverse)) == 1);
+      }
+    }
+  }
+}
+
+TEST_CASE("ModRingMany", "[ModInt]") {
+  std::mt19937_64 gen(16);
+  for (const uint64_t modulus : {uint64_t{3}, uint64_t{998244353}, uint64_t{4294967291u}, uint64_t{4294967294u},
+                                 (uint64_t{1} << 61) - 1, uint64_t{18446744073709551614u}}) {
+    const ModRing ring(modulus);
+    // Sizes around the kModIntLanes blocks of the vectorized kernel.
+    for (const size_t size : {size_t{0}, size_t{1}, kModIntLanes - 1, kModIntLanes, 3 * kModIntLanes + 5}) {
+      std::vector<uint64_t> a(size);
+      std::vector<uint64_t> b(size);
+      for (size_t i = 0; i < size; ++i) {
+        a[i] = i == 0 ? modulus - 1 : gen() % modulus;
+        b[i] = i == 0 ? modulus - 1 : gen() % modulus;
+      }
+      std::vector<uint64_t> out(size);
+      ring.MulMany(a, b, out);
+      for (size_t i = 0; i < size; ++i) {
+        REQUIRE(out[i] == ring.From(ring.Mul(ring.To(a[i]), ring.To(b[i]))));
+      }
+      for (const uint64_t exponent : {uint64_t{0}, uint64_t{1}, uint64_t{2}, modulus - 2, gen()}) {
+        ring.PowMany(a, exponent, out);
+        for (size_t i = 0; i < size; ++i) {
+          REQUIRE(out[i] == ring.From(ring.Pow(ring.To(a[i]), exponent)));
+        }
+      }
+    }
+  }
+
+  const ModRing ring(7);
+  std::vector<uint64_t> values{1, 2, 3};
+  std::vector<uint64_t> out(2);
+  REQUIRE_THROWS_AS(ring.MulMany(values, values, out), ModIntSizeMismatch);
+  REQUIRE_THROWS_AS(ring.MulMany(values, std::span<const uint64_t>(values).first(2), values), ModIntSizeMismatch);
+  REQUIRE_THROWS_AS(ring.PowMany(values, 3, out), ModIntSizeMismatch);
+}
+
+TEST_CASE("ModInt", "[ModInt]") {
+  using M = ModInt<998244353>;
+  static_assert(M(3) * M(5) == M(15));
+  static_assert((M(2).Pow(23) - 1).Value() == 8388607);
+  static_assert(M(-1).Value() == 998244352);
+  static_assert((M(1) / 3 * 3).Value() == 1);
+
+  REQUIRE(M().Value() == 0);
+  REQUIRE(M(998244353).Value() == 0);
+  REQUIRE(M(std::numeric_limits<int64_t>::min()).Value() ==
+          998244353 - (uint64_t{1} << 63) % 998244353);
+  REQUIRE((-M(5)).Value() == 998244348);
+  REQUIRE(M(0).Inverse() == std::nullopt);
+  REQUIRE_THROWS_AS(M(1) / 0, ModIntNotInvertible);
+
+  // Fermat's little theorem for the prime modulus.
+  std::mt19937_64 gen(17);
+  for (int i = 0; i < 1000; ++i) {
+    const M x = gen();
+    const M y = gen();
+    if (x != 0) {
+      REQUIRE(x.Pow(998244352) == 1);
+      REQUIRE(x.Inverse() == x.Pow(998244351));
+      REQUIRE(y / x * x == y);
+    }
+    REQUIRE((x + y) * (x - y) == x * x - y * y);
+  }
+
+  // An even modulus, where only the odd residues are invertible.
+  using E = ModInt<1000>;
+  REQUIRE((E(999) * 999).Value() == 1);
+  REQUIRE(E(7).Inverse() == E(143));
+  REQUIRE(E(10).Inverse() == std::nullopt);
+  REQUIRE((E(3) - 5).Value() == 998);
+  REQUIRE(E(-1001).Value() == 999);
+  using W = ModInt<uint64_t{1} << 63>;
+  REQUIRE((W(uint64_t{3} << 61) * 6).Value() == uint64_t{1} << 62);
+  REQUIRE(W(3).Pow(uint64_t{1} << 61) == 1);
+}
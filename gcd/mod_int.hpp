@@ -0,0 +1,458 @@
+#pragma once
+#ifndef MOD_INT_HPP
+#define MOD_INT_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+
+#include "big_uint.hpp"
+#include "gcd.hpp"
+
+class ModIntInvalidModulus : public std::invalid_argument {
+ public:
+  ModIntInvalidModulus() : std::invalid_argument("ModIntInvalidModulus") {
+  }
+};
+
+class ModIntNotInvertible : public std::domain_error {
+ public:
+  ModIntNotInvertible() : std::domain_error("ModIntNotInvertible") {
+  }
+};
+
+class ModIntSizeMismatch : public std::invalid_argument {
+ public:
+  ModIntSizeMismatch() : std::invalid_argument("ModIntSizeMismatch") {
+  }
+};
+
+// Values that ModRing::MulMany and ModRing::PowMany carry through one pass of their vectorized kernel.
+inline constexpr size_t kModIntLanes = 64;
+
+namespace gcd_internal {
+
+// High and low halves of the double-width product x * y.
+constexpr std::pair<uint32_t, uint32_t> MulFull(uint32_t x, uint32_t y) {
+  const auto product = uint64_t{x} * y;
+  return {static_cast<uint32_t>(product >> 32), static_cast<uint32_t>(product)};
+}
+
+constexpr std::pair<uint64_t, uint64_t> MulFull(uint64_t x, uint64_t y) {
+  uint64_t high = 0;
+  const auto low = MulWide(x, y, high);
+  return {high, low};
+}
+
+#ifdef __SIZEOF_INT128__
+constexpr std::pair<Uint128, Uint128> MulFull(Uint128 x, Uint128 y) {
+  const auto x0 = static_cast<uint64_t>(x);
+  const auto x1 = static_cast<uint64_t>(x >> 64);
+  const auto y0 = static_cast<uint64_t>(y);
+  const auto y1 = static_cast<uint64_t>(y >> 64);
+  const auto p00 = Uint128{x0} * y0;
+  const auto p01 = Uint128{x0} * y1;
+  const auto p10 = Uint128{x1} * y0;
+  const auto p11 = Uint128{x1} * y1;
+  const auto middle = (p00 >> 64) + static_cast<uint64_t>(p01) + static_cast<uint64_t>(p10);
+  return {p11 + (p01 >> 64) + (p10 >> 64) + (middle >> 64), middle << 64 | static_cast<uint64_t>(p00)};
+}
+#endif
+
+// Arithmetic modulo an odd n > 1 on residues in Montgomery form x R mod n, where R = 2^bits of U: a product takes
+// three multiplications and no division.
+template <class U>
+class Montgomery {
+ public:
+  constexpr Montgomery() = default;
+
+  constexpr explicit Montgomery(U modulus) : modulus_(modulus) {
+    // n is its own inverse modulo 8, and each Newton step inverse *= 2 - n inverse doubles the number of right bits.
+    inverse_ = modulus;
+    for (int i = 0; i < 7; ++i) {
+      inverse_ *= 2 - modulus * inverse_;
+    }
+    one_ = static_cast<U>(0 - modulus) % modulus;
+    r_squared_ = one_;
+    for (int i = 0; i < std::numeric_limits<U>::digits; ++i) {
+      r_squared_ = Add(r_squared_, r_squared_);
+    }
+  }
+
+  constexpr U Modulus() const {
+    return modulus_;
+  }
+
+  // R mod n, the Montgomery form of 1.
+  constexpr U One() const {
+    return one_;
+  }
+
+  // R^2 mod n, the Montgomery form of R: Mul by it takes a value into Montgomery form.
+  constexpr U RSquared() const {
+    return r_squared_;
+  }
+
+  constexpr U To(U x) const {
+    return Mul(x % modulus_, r_squared_);
+  }
+
+  constexpr U From(U x) const {
+    return Reduce(0, x);
+  }
+
+  constexpr U Add(U x, U y) const {
+    const U sum = x + y;
+    return sum < x || sum >= modulus_ ? sum - modulus_ : sum;
+  }
+
+  constexpr U Sub(U x, U y) const {
+    return x >= y ? x - y : x - y + modulus_;
+  }
+
+  constexpr U Mul(U x, U y) const {
+    const auto [high, low] = MulFull(x, y);
+    return Reduce(high, low);
+  }
+
+  constexpr U Pow(U base, U exponent) const {
+    auto result = one_;
+    for (; exponent != 0; exponent >>= 1) {
+      if ((exponent & 1) != 0) {
+        result = Mul(result, base);
+      }
+      base = Mul(base, base);
+    }
+    return result;
+  }
+
+ private:
+  // (high R + low) / R mod n for high < n: m = low / n mod R makes high R + low - m n divisible by R, and the low
+  // halves cancel.
+  constexpr U Reduce(U high, U low) const {
+    const U m = low * inverse_;
+    const auto subtrahend = MulFull(m, modulus_).first;
+    return high >= subtrahend ? high - subtrahend : high - subtrahend + modulus_;
+  }
+
+  U modulus_{};
+  U inverse_{};
+  U one_{};
+  U r_squared_{};
+};
+
+// Remainders modulo n < 2^32 of numbers below n^2 by Barrett reduction: the quotient is estimated with the
+// precomputed factor floor((2^64 - 1) / n), which leaves it short by at most one.
+class Barrett {
+ public:
+  constexpr Barrett() = default;
+
+  constexpr explicit Barrett(uint64_t modulus) : modulus_(modulus), factor_(~uint64_t{0} / modulus) {
+  }
+
+  constexpr uint64_t Reduce(uint64_t x) const {
+    uint64_t quotient = 0;
+    MulWide(x, factor_, quotient);
+    const auto remainder = x - quotient * modulus_;
+    return remainder >= modulus_ ? remainder - modulus_ : remainder;
+  }
+
+ private:
+  uint64_t modulus_ = 1;
+  uint64_t factor_ = 0;
+};
+
+enum class ModReduction { kMontgomery, kBarrett, kDivision };
+
+// x[i] = x[i] y[i] / R mod n for a block of kModIntLanes residues below n. The reduction is branch-free, so for a
+// 32-bit U all of its products are 32 x 32-bit ones and the loop vectorizes.
+template <class U>
+GCD_MULTIVERSION void MontgomeryMulLanes(const Montgomery<U>& montgomery, U* __restrict x, const U* __restrict y) {
+  const auto mont = montgomery;
+  for (size_t lane = 0; lane < kModIntLanes; ++lane) {
+    x[lane] = mont.Mul(x[lane], y[lane]);
+  }
+}
+
+// x[i] = x[i]^2 / R mod n, the same for y == x, which the restrict pointers above rule out.
+template <class U>
+GCD_MULTIVERSION void MontgomerySquareLanes(const Montgomery<U>& montgomery, U* __restrict x) {
+  const auto mont = montgomery;
+  for (size_t lane = 0; lane < kModIntLanes; ++lane) {
+    x[lane] = mont.Mul(x[lane], x[lane]);
+  }
+}
+
+}  // namespace gcd_internal
+
+// Arithmetic modulo a modulus n >= 2 chosen at run time. Elements are kept in an internal form: To takes any value
+// into it and From brings an element back to its residue in [0, n). Products of odd moduli go through Montgomery
+// reduction, of even ones below 2^32 through Barrett reduction, and only even moduli of 33 bits and more are left with
+// a hardware division. Throws ModIntInvalidModulus for n < 2.
+class ModRing {
+ public:
+  constexpr explicit ModRing(uint64_t modulus)
+      : modulus_(CheckModulus(modulus)),
+        reduction_(modulus % 2 == 1    ? gcd_internal::ModReduction::kMontgomery
+                   : modulus >> 32 == 0 ? gcd_internal::ModReduction::kBarrett
+                                        : gcd_internal::ModReduction::kDivision),
+        montgomery_(modulus % 2 == 1 ? gcd_internal::Montgomery<uint64_t>(modulus)
+                                     : gcd_internal::Montgomery<uint64_t>()),
+        barrett_(modulus >> 32 == 0 ? gcd_internal::Barrett(modulus) : gcd_internal::Barrett()) {
+  }
+
+  constexpr uint64_t Modulus() const {
+    return modulus_;
+  }
+
+  constexpr uint64_t One() const {
+    return reduction_ == gcd_internal::ModReduction::kMontgomery ? montgomery_.One() : 1;
+  }
+
+  constexpr uint64_t To(uint64_t x) const {
+    return reduction_ == gcd_internal::ModReduction::kMontgomery ? montgomery_.To(x) : x % modulus_;
+  }
+
+  constexpr uint64_t From(uint64_t x) const {
+    return reduction_ == gcd_internal::ModReduction::kMontgomery ? montgomery_.From(x) : x;
+  }
+
+  constexpr uint64_t Add(uint64_t x, uint64_t y) const {
+    const auto sum = x + y;
+    return sum < x || sum >= modulus_ ? sum - modulus_ : sum;
+  }
+
+  constexpr uint64_t Sub(uint64_t x, uint64_t y) const {
+    return x >= y ? x - y : x - y + modulus_;
+  }
+
+  constexpr uint64_t Mul(uint64_t x, uint64_t y) const {
+    switch (reduction_) {
+      case gcd_internal::ModReduction::kMontgomery:
+        return montgomery_.Mul(x, y);
+      case gcd_internal::ModReduction::kBarrett:
+        return barrett_.Reduce(x * y);
+      case gcd_internal::ModReduction::kDivision:
+        break;
+    }
+    uint64_t high = 0;
+    const auto low = gcd_internal::MulWide(x, y, high);
+    uint64_t remainder = 0;
+    gcd_internal::DivWide(high, low, modulus_, remainder);
+    return remainder;
+  }
+
+  constexpr uint64_t Pow(uint64_t base, uint64_t exponent) const {
+    auto result = One();
+    for (; exponent != 0; exponent >>= 1) {
+      if ((exponent & 1) != 0) {
+        result = Mul(result, base);
+      }
+      base = Mul(base, base);
+    }
+    return result;
+  }
+
+  // The inverse of an element by ModInverse, nullopt if its residue and n are not coprime.
+  constexpr std::optional<uint64_t> Inverse(uint64_t x) const {
+    const auto inverse = ModInverse<uint64_t>(From(x), modulus_);
+    if (!inverse) {
+      return std::nullopt;
+    }
+    return To(*inverse);
+  }
+
+  // out[i] = a[i] b[i] mod n on plain residues below n, which need no conversion to and from the internal form. Odd
+  // moduli below 2^32 run kModIntLanes products at a time through 32-bit Montgomery reduction, which vectorizes.
+  // Throws ModIntSizeMismatch unless all three spans have the same size.
+  void MulMany(std::span<const uint64_t> a, std::span<const uint64_t> b, std::span<uint64_t> out) const {
+    if (a.size() != b.size() || a.size() != out.size()) {
+      throw ModIntSizeMismatch{};
+    }
+    if (reduction_ == gcd_internal::ModReduction::kMontgomery && modulus_ >> 32 == 0) {
+      const gcd_internal::Montgomery<uint32_t> mont(static_cast<uint32_t>(modulus_));
+      std::array<uint32_t, kModIntLanes> r_squared;
+      r_squared.fill(mont.RSquared());
+      for (size_t begin = 0; begin < a.size(); begin += kModIntLanes) {
+        const auto count = std::min(kModIntLanes, a.size() - begin);
+        std::array<uint32_t, kModIntLanes> x{};
+        std::array<uint32_t, kModIntLanes> y{};
+        std::copy_n(a.begin() + begin, count, x.begin());
+        std::copy_n(b.begin() + begin, count, y.begin());
+        // a b / R, then times R^2 / R.
+        gcd_internal::MontgomeryMulLanes(mont, x.data(), y.data());
+        gcd_internal::MontgomeryMulLanes(mont, x.data(), r_squared.data());
+        std::copy_n(x.begin(), count, out.begin() + begin);
+      }
+    } else if (reduction_ == gcd_internal::ModReduction::kMontgomery) {
+      for (size_t i = 0; i < a.size(); ++i) {
+        out[i] = montgomery_.Mul(montgomery_.Mul(a[i], b[i]), montgomery_.RSquared());
+      }
+    } else {
+      for (size_t i = 0; i < a.size(); ++i) {
+        out[i] = Mul(a[i], b[i]);
+      }
+    }
+  }
+
+  // out[i] = bases[i]^exponent mod n on plain residues below n. For odd moduli below 2^32 the bases go through the
+  // square-and-multiply steps kModIntLanes at a time, all lanes sharing the exponent's bits, which vectorizes.
+  // Throws ModIntSizeMismatch if the spans differ in size.
+  void PowMany(std::span<const uint64_t> bases, uint64_t exponent, std::span<uint64_t> out) const {
+    if (bases.size() != out.size()) {
+      throw ModIntSizeMismatch{};
+    }
+    if (reduction_ != gcd_internal::ModReduction::kMontgomery || modulus_ >> 32 != 0) {
+      for (size_t i = 0; i < bases.size(); ++i) {
+        out[i] = From(Pow(To(bases[i]), exponent));
+      }
+      return;
+    }
+    const gcd_internal::Montgomery<uint32_t> mont(static_cast<uint32_t>(modulus_));
+    std::array<uint32_t, kModIntLanes> r_squared;
+    std::array<uint32_t, kModIntLanes> ones;
+    r_squared.fill(mont.RSquared());
+    ones.fill(1);
+    for (size_t begin = 0; begin < bases.size(); begin += kModIntLanes) {
+      const auto count = std::min(kModIntLanes, bases.size() - begin);
+      std::array<uint32_t, kModIntLanes> base{};
+      std::copy_n(bases.begin() + begin, count, base.begin());
+      gcd_internal::MontgomeryMulLanes(mont, base.data(), r_squared.data());
+      std::array<uint32_t, kModIntLanes> result;
+      result.fill(mont.One());
+      for (auto bit = std::bit_width(exponent); bit-- > 0;) {
+        gcd_internal::MontgomerySquareLanes(mont, result.data());
+        if ((exponent >> bit & 1) != 0) {
+          gcd_internal::MontgomeryMulLanes(mont, result.data(), base.data());
+        }
+      }
+      gcd_internal::MontgomeryMulLanes(mont, result.data(), ones.data());
+      std::copy_n(result.begin(), count, out.begin() + begin);
+    }
+  }
+
+ private:
+  static constexpr uint64_t CheckModulus(uint64_t modulus) {
+    if (modulus < 2) {
+      throw ModIntInvalidModulus{};
+    }
+    return modulus;
+  }
+
+  uint64_t modulus_;
+  gcd_internal::ModReduction reduction_;
+  gcd_internal::Montgomery<uint64_t> montgomery_;
+  gcd_internal::Barrett barrett_;
+};
+
+// An integer modulo kMod >= 2 fixed at compile time, on top of the ModRing for kMod. Converts implicitly from built-in
+// integers of up to 64 bits, negative ones included; division throws ModIntNotInvertible for a divisor that is not
+// coprime with kMod.
+template <uint64_t kMod>
+class ModInt {
+  static_assert(kMod >= 2, "ModInt needs a modulus of at least 2");
+
+ public:
+  static constexpr ModRing kRing{kMod};
+
+  constexpr ModInt() = default;
+
+  template <class T>
+    requires(std::is_integral_v<T> && sizeof(T) <= sizeof(uint64_t))
+  constexpr ModInt(T value)  // NOLINT
+      : value_(ToInternal(value)) {
+  }
+
+  // The residue in [0, kMod).
+  constexpr uint64_t Value() const {
+    return kRing.From(value_);
+  }
+
+  constexpr ModInt Pow(uint64_t exponent) const {
+    return FromInternal(kRing.Pow(value_, exponent));
+  }
+
+  constexpr std::optional<ModInt> Inverse() const {
+    const auto inverse = kRing.Inverse(value_);
+    if (!inverse) {
+      return std::nullopt;
+    }
+    return FromInternal(*inverse);
+  }
+
+  constexpr ModInt operator-() const {
+    return FromInternal(kRing.Sub(0, value_));
+  }
+
+  constexpr ModInt& operator+=(ModInt other) {
+    value_ = kRing.Add(value_, other.value_);
+    return *this;
+  }
+
+  constexpr ModInt& operator-=(ModInt other) {
+    value_ = kRing.Sub(value_, other.value_);
+    return *this;
+  }
+
+  constexpr ModInt& operator*=(ModInt other) {
+    value_ = kRing.Mul(value_, other.value_);
+    return *this;
+  }
+
+  constexpr ModInt& operator/=(ModInt other) {
+    const auto inverse = other.Inverse();
+    if (!inverse) {
+      throw ModIntNotInvertible{};
+    }
+    return *this *= *inverse;
+  }
+
+  friend constexpr ModInt operator+(ModInt lhs, ModInt rhs) {
+    return lhs += rhs;
+  }
+
+  friend constexpr ModInt operator-(ModInt lhs, ModInt rhs) {
+    return lhs -= rhs;
+  }
+
+  friend constexpr ModInt operator*(ModInt lhs, ModInt rhs) {
+    return lhs *= rhs;
+  }
+
+  friend constexpr ModInt operator/(ModInt lhs, ModInt rhs) {
+    return lhs /= rhs;
+  }
+
+  // Every residue has a single internal form, so comparing the forms compares the residues.
+  friend constexpr bool operator==(ModInt lhs, ModInt rhs) = default;
+
+ private:
+  template <class T>
+  static constexpr uint64_t ToInternal(T value) {
+    if constexpr (std::is_signed_v<T>) {
+      if (value < 0) {
+        // Converted as it is, a negative value would wrap around to 2^64 - |value|.
+        return kRing.Sub(0, kRing.To(uint64_t{0} - static_cast<uint64_t>(value)));
+      }
+    }
+    return kRing.To(static_cast<uint64_t>(value));
+  }
+
+  static constexpr ModInt FromInternal(uint64_t value) {
+    ModInt result;
+    result.value_ = value;
+    return result;
+  }
+
+  uint64_t value_ = 0;
+};
+
+#endif
@@ -0,0 +1,321 @@
+#pragma once
+#ifndef POLYNOMIAL_HPP
+#define POLYNOMIAL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <initializer_list>
+#include <limits>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "gcd.hpp"
+
+class PolynomialOverflow : public std::overflow_error {
+ public:
+  PolynomialOverflow() : std::overflow_error("PolynomialOverflow") {
+  }
+};
+
+namespace gcd_internal {
+
+// Coefficient arithmetic that throws PolynomialOverflow when a result of a built-in integer type does not fit; other
+// coefficient types are exact and use their own operators.
+template <class T>
+T CheckedAdd(T x, T y) {
+  if constexpr (std::is_integral_v<T>) {
+    T sum{};
+#if defined(__GNUC__)
+    const auto overflow = __builtin_add_overflow(x, y, &sum);
+#else
+    const auto overflow = y > T{0} ? x > std::numeric_limits<T>::max() - y : x < std::numeric_limits<T>::min() - y;
+    sum = static_cast<T>(x + y);
+#endif
+    if (overflow) {
+      throw PolynomialOverflow{};
+    }
+    return sum;
+  } else {
+    return x + y;
+  }
+}
+
+template <class T>
+T CheckedSub(T x, T y) {
+  if constexpr (std::is_integral_v<T>) {
+    T difference{};
+#if defined(__GNUC__)
+    const auto overflow = __builtin_sub_overflow(x, y, &difference);
+#else
+    const auto overflow = y > T{0} ? x < std::numeric_limits<T>::min() + y : x > std::numeric_limits<T>::max() + y;
+    difference = static_cast<T>(x - y);
+#endif
+    if (overflow) {
+      throw PolynomialOverflow{};
+    }
+    return difference;
+  } else {
+    return x - y;
+  }
+}
+
+template <class T>
+T CheckedMul(T x, T y) {
+  if constexpr (std::is_integral_v<T>) {
+    T product{};
+#if defined(__GNUC__)
+    const auto overflow = __builtin_mul_overflow(x, y, &product);
+#else
+    constexpr auto kMax = std::numeric_limits<T>::max();
+    constexpr auto kMin = std::numeric_limits<T>::min();
+    auto overflow = false;
+    if (x > T{0}) {
+      overflow = y > T{0} ? x > kMax / y : y < kMin / x;
+    } else if (x < T{0}) {
+      overflow = y > T{0} ? x < kMin / y : y < T{0} && x < kMax / y;
+    }
+    product = static_cast<T>(x * y);
+#endif
+    if (overflow) {
+      throw PolynomialOverflow{};
+    }
+    return product;
+  } else {
+    return x * y;
+  }
+}
+
+template <class T>
+T CheckedAbs(T x) {
+  return x < T{0} ? CheckedSub(T{0}, x) : x;
+}
+
+template <class T>
+T CheckedPow(T base, int exponent) {
+  T result{1};
+  for (int i = 0; i < exponent; ++i) {
+    result = CheckedMul(result, base);
+  }
+  return result;
+}
+
+}  // namespace gcd_internal
+
+// Dense polynomial with coefficients in an integral domain T, a signed integer type or any exact type with the usual
+// operators and Gcd. Coefficients are stored from the constant term up and the leading one is never zero, so the zero
+// polynomial has no coefficients and degree -1. Arithmetic on built-in integers throws PolynomialOverflow instead of
+// wrapping around.
+template <class T>
+class Polynomial {
+ public:
+  Polynomial() = default;
+
+  Polynomial(T constant)  // NOLINT
+      : coefficients_{constant} {
+    Normalize();
+  }
+
+  Polynomial(std::initializer_list<T> coefficients) : coefficients_(coefficients) {
+    Normalize();
+  }
+
+  explicit Polynomial(std::vector<T> coefficients) : coefficients_(std::move(coefficients)) {
+    Normalize();
+  }
+
+  const std::vector<T>& Coefficients() const {
+    return coefficients_;
+  }
+
+  int Degree() const {
+    return static_cast<int>(coefficients_.size()) - 1;
+  }
+
+  bool IsZero() const {
+    return coefficients_.empty();
+  }
+
+  // Coefficient of x^power, zero beyond the degree.
+  T operator[](size_t power) const {
+    return power < coefficients_.size() ? coefficients_[power] : T{0};
+  }
+
+  T Leading() const {
+    return IsZero() ? T{0} : coefficients_.back();
+  }
+
+  // Gcd of the coefficients with the sign of the leading one, 0 for the zero polynomial.
+  T Content() const {
+    T content{0};
+    for (const auto& coefficient : coefficients_) {
+      content = Gcd(content, gcd_internal::CheckedAbs(coefficient));
+    }
+    return Leading() < T{0} ? T{0} - content : content;
+  }
+
+  // The polynomial divided by its content, with a positive leading coefficient.
+  Polynomial PrimitivePart() const {
+    auto result = *this;
+    if (!IsZero()) {
+      result.DivideExactly(Content());
+    }
+    return result;
+  }
+
+  // Divides every coefficient by a divisor known to divide all of them.
+  void DivideExactly(T divisor) {
+    for (auto& coefficient : coefficients_) {
+      coefficient /= divisor;
+    }
+  }
+
+  Polynomial operator-() const {
+    auto result = *this;
+    for (auto& coefficient : result.coefficients_) {
+      coefficient = gcd_internal::CheckedSub(T{0}, coefficient);
+    }
+    return result;
+  }
+
+  Polynomial& operator+=(const Polynomial& other) {
+    coefficients_.resize(std::max(coefficients_.size(), other.coefficients_.size()), T{0});
+    for (size_t i = 0; i < other.coefficients_.size(); ++i) {
+      coefficients_[i] = gcd_internal::CheckedAdd(coefficients_[i], other.coefficients_[i]);
+    }
+    Normalize();
+    return *this;
+  }
+
+  Polynomial& operator-=(const Polynomial& other) {
+    coefficients_.resize(std::max(coefficients_.size(), other.coefficients_.size()), T{0});
+    for (size_t i = 0; i < other.coefficients_.size(); ++i) {
+      coefficients_[i] = gcd_internal::CheckedSub(coefficients_[i], other.coefficients_[i]);
+    }
+    Normalize();
+    return *this;
+  }
+
+  Polynomial& operator*=(const Polynomial& other) {
+    if (IsZero() || other.IsZero()) {
+      coefficients_.clear();
+      return *this;
+    }
+    std::vector<T> product(coefficients_.size() + other.coefficients_.size() - 1, T{0});
+    for (size_t i = 0; i < coefficients_.size(); ++i) {
+      for (size_t j = 0; j < other.coefficients_.size(); ++j) {
+        const auto term = gcd_internal::CheckedMul(coefficients_[i], other.coefficients_[j]);
+        product[i + j] = gcd_internal::CheckedAdd(product[i + j], term);
+      }
+    }
+    coefficients_ = std::move(product);
+    Normalize();
+    return *this;
+  }
+
+  friend bool operator==(const Polynomial& lhs, const Polynomial& rhs) = default;
+
+ private:
+  void Normalize() {
+    while (!coefficients_.empty() && coefficients_.back() == T{0}) {
+      coefficients_.pop_back();
+    }
+  }
+
+  std::vector<T> coefficients_;
+};
+
+template <class T>
+Polynomial<T> operator+(Polynomial<T> lhs, const Polynomial<T>& rhs) {
+  return lhs += rhs;
+}
+
+template <class T>
+Polynomial<T> operator-(Polynomial<T> lhs, const Polynomial<T>& rhs) {
+  return lhs -= rhs;
+}
+
+template <class T>
+Polynomial<T> operator*(Polynomial<T> lhs, const Polynomial<T>& rhs) {
+  return lhs *= rhs;
+}
+
+namespace gcd_internal {
+
+// The remainder of lc(b)^(deg a - deg b + 1) a divided by b, which needs no division of coefficients. A step is only
+// taken for a term that is still there, so a remainder that drops several degrees at once or becomes 0 early saves the
+// multiplications by lc(b) of the steps it skips; their factors are put back at the end.
+template <class T>
+Polynomial<T> PseudoRemainder(const Polynomial<T>& a, const Polynomial<T>& b) {
+  auto coefficients = a.Coefficients();
+  const auto& divisor = b.Coefficients();
+  const auto leading = b.Leading();
+  auto unused_steps = a.Degree() - b.Degree() + 1;
+  while (coefficients.size() >= divisor.size()) {
+    // coefficients = lc(b) coefficients - c x^shift b, with c the leading coefficient, cancels the leading term.
+    const auto factor = coefficients.back();
+    const auto shift = coefficients.size() - divisor.size();
+    for (size_t i = 0; i < shift; ++i) {
+      coefficients[i] = CheckedMul(coefficients[i], leading);
+    }
+    for (size_t i = 0; i < divisor.size(); ++i) {
+      coefficients[shift + i] =
+          CheckedSub(CheckedMul(coefficients[shift + i], leading), CheckedMul(factor, divisor[i]));
+    }
+    coefficients.pop_back();
+    while (!coefficients.empty() && coefficients.back() == T{0}) {
+      coefficients.pop_back();
+    }
+    --unused_steps;
+  }
+  Polynomial<T> remainder(std::move(coefficients));
+  if (unused_steps > 0 && !remainder.IsZero()) {
+    remainder *= Polynomial<T>(CheckedPow(leading, unused_steps));
+  }
+  return remainder;
+}
+
+}  // namespace gcd_internal
+
+// Greatest common divisor of two polynomials over the integers (or another unique factorization domain T), normalized
+// to a positive leading coefficient; Gcd(0, 0) == 0. The contents are split off with the coefficient Gcd and the
+// primitive parts run through the subresultant pseudo-remainder sequence (Collins, Brown), whose divisions by g h^delta
+// are exact and keep the coefficients within the size of the subresultants, where plain Euclid lets them grow
+// exponentially with every step.
+template <class T>
+Polynomial<T> Gcd(Polynomial<T> a, Polynomial<T> b) {
+  if (a.Degree() < b.Degree()) {
+    std::swap(a, b);
+  }
+  if (b.IsZero()) {
+    return a.Leading() < T{0} ? -a : a;
+  }
+  const auto content = Gcd(gcd_internal::CheckedAbs(a.Content()), gcd_internal::CheckedAbs(b.Content()));
+  a = a.PrimitivePart();
+  b = b.PrimitivePart();
+  T g{1};
+  T h{1};
+  while (true) {
+    const auto delta = a.Degree() - b.Degree();
+    auto remainder = gcd_internal::PseudoRemainder(a, b);
+    if (remainder.IsZero()) {
+      break;
+    }
+    if (remainder.Degree() == 0) {
+      b = T{1};
+      break;
+    }
+    remainder.DivideExactly(gcd_internal::CheckedMul(g, gcd_internal::CheckedPow(h, delta)));
+    a = std::move(b);
+    b = std::move(remainder);
+    g = a.Leading();
+    if (delta > 0) {
+      h = gcd_internal::CheckedPow(g, delta) / gcd_internal::CheckedPow(h, delta - 1);
+    }
+  }
+  auto result = b.PrimitivePart();
+  return result *= Polynomial<T>(content);
+}
+
+#endif
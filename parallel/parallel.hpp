@@ -0,0 +1,81 @@
+#pragma once
+#ifndef PARALLEL_HPP
+#define PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace parallel_internal {
+
+// Number of threads to run num_tasks tasks on: 0 means "one per hardware thread", never more threads than tasks.
+inline size_t ResolveThreadCount(size_t num_threads, size_t num_tasks) {
+  if (num_threads == 0) {
+    num_threads = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  return std::max<size_t>(std::min(num_threads, num_tasks), 1);
+}
+
+// Calls task(i) for every i in [0, num_tasks) on up to num_threads threads (the calling thread included). Workers
+// claim tasks one by one from a shared counter, so a thread that finishes early keeps taking work from the slower
+// ones instead of idling. The first exception thrown by a task is rethrown in the calling thread, and so is a failure
+// to start a thread, once the threads started before it are joined.
+template <class Task>
+void ParallelFor(size_t num_tasks, size_t num_threads, const Task& task) {
+  num_threads = ResolveThreadCount(num_threads, num_tasks);
+  if (num_threads == 1) {
+    for (size_t i = 0; i < num_tasks; ++i) {
+      task(i);
+    }
+    return;
+  }
+
+  std::atomic<size_t> next_task = 0;
+  std::exception_ptr error;
+  std::mutex error_mutex;
+  const auto worker = [&] {
+    for (auto i = next_task.fetch_add(1, std::memory_order_relaxed); i < num_tasks;
+         i = next_task.fetch_add(1, std::memory_order_relaxed)) {
+      try {
+        task(i);
+      } catch (...) {
+        const std::lock_guard lock(error_mutex);
+        if (!error) {
+          error = std::current_exception();
+        }
+        next_task.store(num_tasks, std::memory_order_relaxed);
+      }
+    }
+  };
+
+  std::vector<std::thread> threads;
+  const auto join_all = [&] {
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+  try {
+    threads.reserve(num_threads - 1);
+    for (size_t i = 1; i < num_threads; ++i) {
+      threads.emplace_back(worker);
+    }
+  } catch (...) {
+    // A joinable std::thread that goes out of scope calls std::terminate.
+    next_task.store(num_tasks, std::memory_order_relaxed);
+    join_all();
+    throw;
+  }
+  worker();
+  join_all();
+  if (error) {
+    std::rethrow_exception(error);
+  }
+}
+
+}  // namespace parallel_internal
+
+#endif
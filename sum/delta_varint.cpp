@@ -0,0 +1,151 @@
+#include "delta_varint.h"
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+
+namespace {
+
+constexpr size_t kCountBytes = 8;
+constexpr size_t kPadding = 3;
+constexpr size_t kValuesPerControlByte = 4;
+
+constexpr uint32_t kLengthMask[4] = {0xFF, 0xFFFF, 0xFFFFFF, 0xFFFFFFFF};
+
+// Total data length of the four values described by a control byte.
+constexpr std::array<uint8_t, 256> MakeQuadLengths() {
+  std::array<uint8_t, 256> lengths{};
+  for (size_t control = 0; control < lengths.size(); ++control) {
+    for (size_t j = 0; j < kValuesPerControlByte; ++j) {
+      lengths[control] += static_cast<uint8_t>(((control >> (2 * j)) & 3) + 1);
+    }
+  }
+  return lengths;
+}
+
+constexpr auto kQuadLength = MakeQuadLengths();
+
+// Deltas are taken modulo 2^32, so every pair of ints has one; zigzag maps small negative deltas to small codes.
+uint32_t ZigZagEncode(uint32_t delta) {
+  return (delta << 1) ^ (0U - (delta >> 31));
+}
+
+uint32_t ZigZagDecode(uint32_t code) {
+  return (code >> 1) ^ (0U - (code & 1));
+}
+
+uint32_t LoadLittleEndian32(const uint8_t* data) {
+  if constexpr (std::endian::native == std::endian::little) {
+    uint32_t value = 0;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+  } else {
+    return uint32_t{data[0]} | uint32_t{data[1]} << 8 | uint32_t{data[2]} << 16 | uint32_t{data[3]} << 24;
+  }
+}
+
+struct Layout {
+  size_t count;
+  const uint8_t* control;
+  const uint8_t* data;
+};
+
+// Checks that the buffer holds exactly the bytes its count and control bytes describe, so decoding never has to
+// check bounds.
+Layout Parse(std::span<const uint8_t> encoded) {
+  if (encoded.size() < kCountBytes + kPadding) {
+    throw DeltaVarintCorrupted{};
+  }
+  uint64_t count = 0;
+  for (size_t i = 0; i < kCountBytes; ++i) {
+    count |= uint64_t{encoded[i]} << (8 * i);
+  }
+  if (count / kValuesPerControlByte > encoded.size()) {
+    throw DeltaVarintCorrupted{};
+  }
+  const auto control_size = static_cast<size_t>((count + kValuesPerControlByte - 1) / kValuesPerControlByte);
+  if (kCountBytes + control_size + kPadding > encoded.size()) {
+    throw DeltaVarintCorrupted{};
+  }
+  const auto* control = encoded.data() + kCountBytes;
+  const auto full_quads = static_cast<size_t>(count / kValuesPerControlByte);
+  size_t data_size = 0;
+  for (size_t q = 0; q < full_quads; ++q) {
+    data_size += kQuadLength[control[q]];
+  }
+  for (size_t j = 0; j < count % kValuesPerControlByte; ++j) {
+    data_size += ((control[full_quads] >> (2 * j)) & 3) + 1;
+  }
+  if (kCountBytes + control_size + data_size + kPadding != encoded.size()) {
+    throw DeltaVarintCorrupted{};
+  }
+  return {static_cast<size_t>(count), control, control + control_size};
+}
+
+// Calls visit(value) for every encoded value in order.
+template <class Visitor>
+inline void ForEachValue(const Layout& layout, Visitor visit) {
+  const auto* data = layout.data;
+  uint32_t previous = 0;
+  const auto decode = [&](uint32_t length_code) {
+    previous += ZigZagDecode(LoadLittleEndian32(data) & kLengthMask[length_code]);
+    data += length_code + 1;
+    visit(static_cast<int>(previous));
+  };
+  const auto full_quads = layout.count / kValuesPerControlByte;
+  for (size_t q = 0; q < full_quads; ++q) {
+    const uint32_t control = layout.control[q];
+    decode(control & 3);
+    decode((control >> 2) & 3);
+    decode((control >> 4) & 3);
+    decode(control >> 6);
+  }
+  for (size_t j = 0; j < layout.count % kValuesPerControlByte; ++j) {
+    decode((layout.control[full_quads] >> (2 * j)) & 3U);
+  }
+}
+
+}  // namespace
+
+std::vector<uint8_t> EncodeDeltaVarint(std::span<const int> values) {
+  const auto control_size = (values.size() + kValuesPerControlByte - 1) / kValuesPerControlByte;
+  std::vector<uint8_t> encoded(kCountBytes + control_size + values.size() * sizeof(uint32_t) + kPadding);
+  for (size_t i = 0; i < kCountBytes; ++i) {
+    encoded[i] = static_cast<uint8_t>(uint64_t{values.size()} >> (8 * i));
+  }
+  auto* control = encoded.data() + kCountBytes;
+  auto* data = control + control_size;
+  uint32_t previous = 0;
+  for (size_t i = 0; i < values.size(); ++i) {
+    const auto code = ZigZagEncode(static_cast<uint32_t>(values[i]) - previous);
+    previous = static_cast<uint32_t>(values[i]);
+    const size_t length = code < (1U << 8) ? 1 : code < (1U << 16) ? 2 : code < (1U << 24) ? 3 : 4;
+    control[i / kValuesPerControlByte] |= static_cast<uint8_t>((length - 1) << (2 * (i % kValuesPerControlByte)));
+    for (size_t j = 0; j < length; ++j) {
+      *data++ = static_cast<uint8_t>(code >> (8 * j));
+    }
+  }
+  // The bytes behind the data were zero-initialized and serve as padding.
+  encoded.resize(static_cast<size_t>(data - encoded.data()) + kPadding);
+  return encoded;
+}
+
+std::vector<int> DecodeDeltaVarint(std::span<const uint8_t> encoded) {
+  const auto layout = Parse(encoded);
+  std::vector<int> values;
+  values.reserve(layout.count);
+  ForEachValue(layout, [&](int value) {
+    values.push_back(value);
+  });
+  return values;
+}
+
+int64_t SumDeltaVarint(std::span<const uint8_t> encoded) {
+  const auto layout = Parse(encoded);
+  int64_t sum = 0;
+  ForEachValue(layout, [&](int value) {
+    sum += value;
+  });
+  return sum;
+}
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef DELTA_VARINT_H
+#define DELTA_VARINT_H
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+class DeltaVarintCorrupted : public std::runtime_error {
+ public:
+  DeltaVarintCorrupted() : std::runtime_error("DeltaVarintCorrupted") {
+  }
+};
+
+// Delta + varint compression of int sequences in the stream-vbyte layout:
+//   * value count, 8 bytes little-endian;
+//   * control bytes, 2 bits per value (byte length - 1), four values per byte;
+//   * data bytes, every value stored as the zigzag-encoded difference to its predecessor in 1-4 bytes;
+//   * 3 zero bytes of padding, so a value can always be read with one 4-byte load.
+// Keeping the lengths apart from the data makes decoding a table lookup per four values instead of a branch per byte.
+std::vector<uint8_t> EncodeDeltaVarint(std::span<const int> values);
+std::vector<int> DecodeDeltaVarint(std::span<const uint8_t> encoded);
+
+// Exact int64 sum of the encoded values, decoded and accumulated in one pass without materializing them.
+// Throws DeltaVarintCorrupted (as does DecodeDeltaVarint) if the buffer is not a valid encoding.
+int64_t SumDeltaVarint(std::span<const uint8_t> encoded);
+
+#endif
@@ -0,0 +1,104 @@
+#include "file_sum.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <span>
+#include <vector>
+
+#include "sum.h"
+
+namespace {
+
+// Input in the other byte order is swapped through a buffer of this many elements.
+constexpr size_t kSwapBufferSize = size_t{1} << 16;
+
+class FileDescriptor {
+ public:
+  explicit FileDescriptor(int fd) : fd_(fd) {
+  }
+  FileDescriptor(const FileDescriptor&) = delete;
+  FileDescriptor& operator=(const FileDescriptor&) = delete;
+  ~FileDescriptor() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  int Get() const {
+    return fd_;
+  }
+
+ private:
+  int fd_;
+};
+
+uint32_t ByteSwap(uint32_t value) {
+  return (value >> 24) | ((value >> 8) & 0xFF00) | ((value << 8) & 0xFF0000) | (value << 24);
+}
+
+int64_t SumWindow(std::span<const int32_t> values, std::endian byte_order, size_t num_threads) {
+  if (byte_order == std::endian::native) {
+    return SumParallel(values, kDefaultSumGrain, num_threads);
+  }
+  std::vector<int32_t> buffer(std::min(values.size(), kSwapBufferSize));
+  int64_t sum = 0;
+  for (size_t i = 0; i < values.size(); i += buffer.size()) {
+    const auto block = values.subspan(i, std::min(buffer.size(), values.size() - i));
+    std::transform(block.begin(), block.end(), buffer.begin(), [](int32_t value) {
+      return static_cast<int32_t>(ByteSwap(static_cast<uint32_t>(value)));
+    });
+    sum += SumRange(std::span<const int32_t>(buffer.data(), block.size()));
+  }
+  return sum;
+}
+
+[[noreturn]] void ThrowErrno(const std::string& path) {
+  throw SumFileError(path + ": " + std::strerror(errno));
+}
+
+}  // namespace
+
+int64_t SumInt32File(const std::string& path, std::endian byte_order, size_t num_threads, size_t window_size) {
+  const FileDescriptor file(open(path.c_str(), O_RDONLY));
+  if (file.Get() < 0) {
+    ThrowErrno(path);
+  }
+  struct stat file_stat {};
+  if (fstat(file.Get(), &file_stat) != 0) {
+    ThrowErrno(path);
+  }
+  const auto file_size = static_cast<size_t>(file_stat.st_size);
+  if (file_size % sizeof(int32_t) != 0) {
+    throw SumFileError(path + ": size is not a multiple of 4 bytes");
+  }
+
+  int64_t total = 0;
+  for (size_t offset = 0; offset < file_size; offset += window_size) {
+    const auto length = std::min(window_size, file_size - offset);
+    void* window = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, file.Get(), static_cast<off_t>(offset));
+    if (window == MAP_FAILED) {
+      ThrowErrno(path);
+    }
+    // Hints only: a kernel that does not support them still maps the file correctly.
+    madvise(window, length, MADV_SEQUENTIAL);
+    madvise(window, length, MADV_WILLNEED);
+#ifdef MADV_HUGEPAGE
+    madvise(window, length, MADV_HUGEPAGE);
+#endif
+    const std::span values(static_cast<const int32_t*>(window), length / sizeof(int32_t));
+    try {
+      total += SumWindow(values, byte_order, num_threads);
+    } catch (...) {
+      munmap(window, length);
+      throw;
+    }
+    munmap(window, length);
+  }
+  return total;
+}
@@ -0,0 +1,30 @@
+#pragma once
+#ifndef FILE_SUM_H
+#define FILE_SUM_H
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+// Carries the message that sum_cli prints: the path and what went wrong with it.
+class SumFileError : public std::runtime_error {
+ public:
+  explicit SumFileError(const std::string& message) : std::runtime_error(message) {
+  }
+};
+
+// 256 MiB is a multiple of every page size (2 MiB huge pages included) and of sizeof(int32_t), so every window starts
+// at a valid mmap offset and on an element boundary.
+inline constexpr size_t kSumFileWindowSize = size_t{256} << 20;
+
+// Exact int64 sum of a raw int32 file stored in the given byte order. The file is memory-mapped window_size bytes at
+// a time and each window is unmapped as soon as it is summed, so it is never copied into the process and the resident
+// memory does not grow with the file size. window_size must be a multiple of the page size. Values in the native byte
+// order are summed on num_threads threads (0 means one per hardware thread), the others are byte-swapped through a
+// small buffer first. Throws SumFileError if the file cannot be read or its size is not a multiple of 4 bytes.
+int64_t SumInt32File(const std::string& path, std::endian byte_order = std::endian::little, size_t num_threads = 0,
+                     size_t window_size = kSumFileWindowSize);
+
+#endif
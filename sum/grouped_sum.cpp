@@ -0,0 +1,255 @@
+#include "grouped_sum.h"
+
+#include <algorithm>
+#include <bit>
+#include <iterator>
+
+#include "parallel/parallel.hpp"
+#include "sum.h"
+
+namespace {
+
+constexpr size_t kGroupSize = 16;
+constexpr size_t kNotFound = static_cast<size_t>(-1);
+// Control byte of a free slot. Occupied slots store the low 7 bits of the key hash, which are never negative.
+constexpr int8_t kEmpty = -128;
+
+// Hashes of this many pairs are computed ahead of the inserts so their table groups can be prefetched.
+constexpr size_t kPrefetchDistance = 16;
+
+// Inputs shorter than this are aggregated by the calling thread alone.
+constexpr size_t kParallelGroupedSumThreshold = size_t{1} << 16;
+// Top hash bits select the partition; the table uses the low bits, so both stay independent.
+constexpr size_t kPartitionBits = 8;
+constexpr size_t kNumPartitions = size_t{1} << kPartitionBits;
+
+using ItemList = std::vector<std::pair<int, int64_t>>;
+
+uint64_t HashKey(int key) {
+  // splitmix64 finalizer: every key bit affects every hash bit.
+  auto hash = static_cast<uint64_t>(static_cast<uint32_t>(key));
+  hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9;
+  hash = (hash ^ (hash >> 27)) * 0x94D049BB133111EB;
+  return hash ^ (hash >> 31);
+}
+
+int8_t Tag(uint64_t hash) {
+  return static_cast<int8_t>(hash & 0x7F);
+}
+
+// Bit j is set iff control[j] == tag. The fixed-size loop compiles to a vector compare and a movemask.
+uint32_t MatchGroup(const int8_t* control, int8_t tag) {
+  uint32_t mask = 0;
+  for (size_t j = 0; j < kGroupSize; ++j) {
+    mask |= static_cast<uint32_t>(control[j] == tag) << j;
+  }
+  return mask;
+}
+
+inline void Prefetch([[maybe_unused]] const void* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address);
+#endif
+}
+
+}  // namespace
+
+void GroupedSum::Add(int key, int64_t value) {
+  sums_[FindOrInsert(key, HashKey(key))] += value;
+}
+
+void GroupedSum::Add(std::span<const int> keys, std::span<const int> values) {
+  if (keys.size() != values.size()) {
+    throw SumSizeMismatch{};
+  }
+  uint64_t hashes[kPrefetchDistance];
+  for (size_t first = 0; first < keys.size(); first += kPrefetchDistance) {
+    const auto count = std::min(kPrefetchDistance, keys.size() - first);
+    const auto group_mask = control_.size() / kGroupSize - 1;
+    for (size_t j = 0; j < count; ++j) {
+      hashes[j] = HashKey(keys[first + j]);
+      if (!control_.empty()) {
+        Prefetch(&control_[((hashes[j] >> 7) & group_mask) * kGroupSize]);
+      }
+    }
+    for (size_t j = 0; j < count; ++j) {
+      sums_[FindOrInsert(keys[first + j], hashes[j])] += values[first + j];
+    }
+  }
+}
+
+void GroupedSum::Merge(const GroupedSum& other) {
+  if (&other == this) {
+    for (auto& sum : sums_) {
+      sum *= 2;
+    }
+    return;
+  }
+  for (size_t slot = 0; slot < other.control_.size(); ++slot) {
+    if (other.control_[slot] != kEmpty) {
+      Add(other.keys_[slot], other.sums_[slot]);
+    }
+  }
+}
+
+int64_t GroupedSum::Get(int key) const {
+  const auto slot = Find(key, HashKey(key));
+  return slot == kNotFound ? 0 : sums_[slot];
+}
+
+bool GroupedSum::Contains(int key) const {
+  return Find(key, HashKey(key)) != kNotFound;
+}
+
+size_t GroupedSum::Size() const {
+  return size_;
+}
+
+bool GroupedSum::Empty() const {
+  return size_ == 0;
+}
+
+std::vector<std::pair<int, int64_t>> GroupedSum::Items() const {
+  ItemList items;
+  items.reserve(size_);
+  for (size_t slot = 0; slot < control_.size(); ++slot) {
+    if (control_[slot] != kEmpty) {
+      items.emplace_back(keys_[slot], sums_[slot]);
+    }
+  }
+  std::sort(items.begin(), items.end());
+  return items;
+}
+
+size_t GroupedSum::Find(int key, uint64_t hash) const {
+  if (control_.empty()) {
+    return kNotFound;
+  }
+  const auto group_mask = control_.size() / kGroupSize - 1;
+  const auto tag = Tag(hash);
+  for (auto group = (hash >> 7) & group_mask;; group = (group + 1) & group_mask) {
+    const auto* control = &control_[group * kGroupSize];
+    for (auto match = MatchGroup(control, tag); match != 0; match &= match - 1) {
+      const auto slot = group * kGroupSize + static_cast<size_t>(std::countr_zero(match));
+      if (keys_[slot] == key) {
+        return slot;
+      }
+    }
+    if (MatchGroup(control, kEmpty) != 0) {
+      return kNotFound;
+    }
+  }
+}
+
+size_t GroupedSum::FindOrInsert(int key, uint64_t hash) {
+  if (control_.empty()) {
+    Grow();
+  }
+  const auto group_mask = control_.size() / kGroupSize - 1;
+  const auto tag = Tag(hash);
+  for (auto group = (hash >> 7) & group_mask;; group = (group + 1) & group_mask) {
+    auto* control = &control_[group * kGroupSize];
+    for (auto match = MatchGroup(control, tag); match != 0; match &= match - 1) {
+      const auto slot = group * kGroupSize + static_cast<size_t>(std::countr_zero(match));
+      if (keys_[slot] == key) {
+        return slot;
+      }
+    }
+    if (const auto empty = MatchGroup(control, kEmpty); empty != 0) {
+      // Only a new key may grow the table, which keeps the load factor at most 7/8, so every probe sequence reaches a
+      // group with a free slot. Updates of existing keys never move the slots.
+      if ((size_ + 1) * 8 > control_.size() * 7) {
+        Grow();
+        return FindOrInsert(key, hash);
+      }
+      const auto slot = group * kGroupSize + static_cast<size_t>(std::countr_zero(empty));
+      control_[slot] = tag;
+      keys_[slot] = key;
+      sums_[slot] = 0;
+      ++size_;
+      return slot;
+    }
+  }
+}
+
+void GroupedSum::Grow() {
+  const auto capacity = control_.empty() ? kGroupSize : control_.size() * 2;
+  auto control = std::exchange(control_, std::vector<int8_t>(capacity, kEmpty));
+  auto keys = std::exchange(keys_, std::vector<int>(capacity));
+  auto sums = std::exchange(sums_, std::vector<int64_t>(capacity));
+  size_ = 0;
+  for (size_t slot = 0; slot < control.size(); ++slot) {
+    if (control[slot] != kEmpty) {
+      sums_[FindOrInsert(keys[slot], HashKey(keys[slot]))] = sums[slot];
+    }
+  }
+}
+
+std::vector<std::pair<int, int64_t>> GroupedSumParallel(std::span<const int> keys, std::span<const int> values,
+                                                        size_t num_threads) {
+  if (keys.size() != values.size()) {
+    throw SumSizeMismatch{};
+  }
+  num_threads = parallel_internal::ResolveThreadCount(num_threads, keys.size() / kParallelGroupedSumThreshold);
+  if (num_threads == 1) {
+    GroupedSum table;
+    table.Add(keys, values);
+    return table.Items();
+  }
+
+  // Partition: every thread counts the partitions of its slice, an exclusive scan over (partition, slice) gives each
+  // slice a private output range inside every partition, and the slices are scattered without synchronization.
+  const auto num_slices = num_threads;
+  const auto slice_size = (keys.size() + num_slices - 1) / num_slices;
+  const auto partition = [](int key) {
+    return static_cast<size_t>(HashKey(key) >> (64 - kPartitionBits));
+  };
+  std::vector<size_t> offsets(num_slices * kNumPartitions);
+  parallel_internal::ParallelFor(num_slices, num_threads, [&](size_t slice) {
+    const auto end = std::min(keys.size(), (slice + 1) * slice_size);
+    for (auto i = slice * slice_size; i < end; ++i) {
+      ++offsets[slice * kNumPartitions + partition(keys[i])];
+    }
+  });
+  std::vector<size_t> partition_begin(kNumPartitions + 1);
+  size_t offset = 0;
+  for (size_t part = 0; part < kNumPartitions; ++part) {
+    partition_begin[part] = offset;
+    for (size_t slice = 0; slice < num_slices; ++slice) {
+      offset += std::exchange(offsets[slice * kNumPartitions + part], offset);
+    }
+  }
+  partition_begin[kNumPartitions] = offset;
+  std::vector<int> partitioned_keys(keys.size());
+  std::vector<int> partitioned_values(values.size());
+  parallel_internal::ParallelFor(num_slices, num_threads, [&](size_t slice) {
+    const auto end = std::min(keys.size(), (slice + 1) * slice_size);
+    for (auto i = slice * slice_size; i < end; ++i) {
+      const auto position = offsets[slice * kNumPartitions + partition(keys[i])]++;
+      partitioned_keys[position] = keys[i];
+      partitioned_values[position] = values[i];
+    }
+  });
+
+  // Aggregate: partitions hold disjoint key sets, so their sorted items only have to be merged.
+  std::vector<ItemList> items(kNumPartitions);
+  parallel_internal::ParallelFor(kNumPartitions, num_threads, [&](size_t part) {
+    const auto begin = partition_begin[part];
+    const auto size = partition_begin[part + 1] - begin;
+    GroupedSum table;
+    table.Add(std::span(partitioned_keys).subspan(begin, size), std::span(partitioned_values).subspan(begin, size));
+    items[part] = table.Items();
+  });
+  for (size_t stride = 1; stride < kNumPartitions; stride *= 2) {
+    parallel_internal::ParallelFor(kNumPartitions / (2 * stride), num_threads, [&](size_t pair) {
+      auto& left = items[2 * stride * pair];
+      auto& right = items[2 * stride * pair + stride];
+      ItemList merged;
+      merged.reserve(left.size() + right.size());
+      std::merge(left.begin(), left.end(), right.begin(), right.end(), std::back_inserter(merged));
+      left = std::move(merged);
+      ItemList().swap(right);
+    });
+  }
+  return std::move(items[0]);
+}
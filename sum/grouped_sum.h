@@ -0,0 +1,49 @@
+#pragma once
+#ifndef GROUPED_SUM_H
+#define GROUPED_SUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Exact int64 sums of values grouped by an int key (GROUP BY key, SUM(value)).
+// Keys are stored in a flat open-addressing table: every slot has a one-byte control tag, and lookups compare the tags
+// of a whole group of 16 slots at once, touching the keys only for slots whose tag matches.
+class GroupedSum {
+ public:
+  GroupedSum() = default;
+
+  void Add(int key, int64_t value);
+  // Adds values[i] to the group of keys[i]. Throws SumSizeMismatch if the spans differ in size.
+  void Add(std::span<const int> keys, std::span<const int> values);
+  void Merge(const GroupedSum& other);
+
+  // Sum of the group, 0 for keys that were never added.
+  int64_t Get(int key) const;
+  bool Contains(int key) const;
+  size_t Size() const;
+  bool Empty() const;
+
+  // All (key, sum) pairs sorted by key.
+  std::vector<std::pair<int, int64_t>> Items() const;
+
+ private:
+  size_t Find(int key, uint64_t hash) const;
+  size_t FindOrInsert(int key, uint64_t hash);
+  void Grow();
+
+  std::vector<int8_t> control_;
+  std::vector<int> keys_;
+  std::vector<int64_t> sums_;
+  size_t size_ = 0;
+};
+
+// Same result as GroupedSum::Add followed by Items(), computed on num_threads threads (0 means one per hardware
+// thread). Pairs are first scattered into partitions by key hash, then each partition is aggregated by one thread into
+// a table of its own, so no table is ever shared between threads.
+std::vector<std::pair<int, int64_t>> GroupedSumParallel(std::span<const int> keys, std::span<const int> values,
+                                                        size_t num_threads = 0);
+
+#endif
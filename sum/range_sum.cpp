@@ -0,0 +1,174 @@
+#include "range_sum.h"
+
+#include <algorithm>
+#include <bit>
+
+#include "sum.h"
+
+namespace {
+
+// Number of tree walks advanced in lockstep by the batched operations.
+constexpr size_t kBatchLanes = 16;
+
+inline size_t LowestBit(size_t i) {
+  return i & (~i + 1);
+}
+
+inline void Prefetch([[maybe_unused]] const void* address) {
+#if defined(__GNUC__)
+  __builtin_prefetch(address);
+#endif
+}
+
+void BuildInPlace(std::vector<int64_t>& tree) {
+  const auto size = tree.size() - 1;
+  for (size_t i = 1; i <= size; ++i) {
+    const auto parent = i + LowestBit(i);
+    if (parent <= size) {
+      tree[parent] += tree[i];
+    }
+  }
+}
+
+// Inverse of BuildInPlace: turns the tree back into plain element values.
+void UnbuildInPlace(std::vector<int64_t>& tree) {
+  const auto size = tree.size() - 1;
+  for (auto i = size; i >= 1; --i) {
+    const auto parent = i + LowestBit(i);
+    if (parent <= size) {
+      tree[parent] -= tree[i];
+    }
+  }
+}
+
+}  // namespace
+
+RangeSumIndex::RangeSumIndex(size_t size) : tree_(size + 1) {
+}
+
+RangeSumIndex::RangeSumIndex(std::span<const int> values) : tree_(values.size() + 1) {
+  for (size_t i = 0; i < values.size(); ++i) {
+    tree_[i + 1] = values[i];
+  }
+  BuildInPlace(tree_);
+}
+
+size_t RangeSumIndex::Size() const {
+  return tree_.size() - 1;
+}
+
+bool RangeSumIndex::Empty() const {
+  return Size() == 0;
+}
+
+int64_t RangeSumIndex::Get(size_t index) const {
+  CheckIndex(index);
+  // Walks from index + 1 and from index meet at a common ancestor; only the parts below it differ.
+  auto value = tree_[index + 1];
+  const auto stop = (index + 1) & index;
+  for (auto i = index; i > stop; i &= i - 1) {
+    value -= tree_[i];
+  }
+  return value;
+}
+
+int64_t RangeSumIndex::PrefixSum(size_t end) const {
+  if (end > Size()) {
+    throw RangeSumOutOfRange{};
+  }
+  int64_t sum = 0;
+  for (auto i = end; i > 0; i &= i - 1) {
+    sum += tree_[i];
+  }
+  return sum;
+}
+
+int64_t RangeSumIndex::RangeSum(size_t begin, size_t end) const {
+  if (begin > end || end > Size()) {
+    throw RangeSumOutOfRange{};
+  }
+  return PrefixSum(end) - PrefixSum(begin);
+}
+
+void RangeSumIndex::Add(size_t index, int64_t delta) {
+  CheckIndex(index);
+  for (auto i = index + 1; i < tree_.size(); i += LowestBit(i)) {
+    tree_[i] += delta;
+  }
+}
+
+void RangeSumIndex::Set(size_t index, int64_t value) {
+  Add(index, value - Get(index));
+}
+
+void RangeSumIndex::RangeSums(std::span<const std::pair<size_t, size_t>> ranges, std::span<int64_t> out) const {
+  if (ranges.size() != out.size()) {
+    throw SumSizeMismatch{};
+  }
+  size_t ends[kBatchLanes];
+  int64_t prefix_sums[kBatchLanes];
+  for (size_t first = 0; first < ranges.size(); first += kBatchLanes / 2) {
+    const auto count = std::min(kBatchLanes / 2, ranges.size() - first);
+    for (size_t j = 0; j < count; ++j) {
+      const auto [begin, end] = ranges[first + j];
+      if (begin > end || end > Size()) {
+        throw RangeSumOutOfRange{};
+      }
+      ends[2 * j] = end;
+      ends[2 * j + 1] = begin;
+    }
+    PrefixSums(ends, 2 * count, prefix_sums);
+    for (size_t j = 0; j < count; ++j) {
+      out[first + j] = prefix_sums[2 * j] - prefix_sums[2 * j + 1];
+    }
+  }
+}
+
+void RangeSumIndex::AddMany(std::span<const size_t> indices, std::span<const int64_t> deltas) {
+  if (indices.size() != deltas.size()) {
+    throw SumSizeMismatch{};
+  }
+  for (const auto index : indices) {
+    CheckIndex(index);
+  }
+  // Point updates cost O(log n) each, a rebuild costs O(n) for the whole batch.
+  if (indices.size() * static_cast<size_t>(std::bit_width(Size())) > Size()) {
+    UnbuildInPlace(tree_);
+    for (size_t j = 0; j < indices.size(); ++j) {
+      tree_[indices[j] + 1] += deltas[j];
+    }
+    BuildInPlace(tree_);
+    return;
+  }
+  for (size_t j = 0; j < indices.size(); ++j) {
+    Add(indices[j], deltas[j]);
+  }
+}
+
+void RangeSumIndex::CheckIndex(size_t index) const {
+  if (index >= Size()) {
+    throw RangeSumOutOfRange{};
+  }
+}
+
+// Advances up to kBatchLanes independent prefix walks one node at a time, prefetching each walk's next node.
+void RangeSumIndex::PrefixSums(const size_t* ends, size_t count, int64_t* out) const {
+  size_t positions[kBatchLanes];
+  bool active = false;
+  for (size_t j = 0; j < count; ++j) {
+    positions[j] = ends[j];
+    out[j] = 0;
+    active = active || positions[j] != 0;
+  }
+  while (active) {
+    active = false;
+    for (size_t j = 0; j < count; ++j) {
+      if (positions[j] != 0) {
+        out[j] += tree_[positions[j]];
+        positions[j] &= positions[j] - 1;
+        Prefetch(&tree_[positions[j]]);
+        active = active || positions[j] != 0;
+      }
+    }
+  }
+}
@@ -0,0 +1,51 @@
+#pragma once
+#ifndef RANGE_SUM_H
+#define RANGE_SUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+class RangeSumOutOfRange : public std::out_of_range {
+ public:
+  RangeSumOutOfRange() : std::out_of_range("RangeSumOutOfRange") {
+  }
+};
+
+// Mutable array of int64 counters answering interval sums and point updates in O(log n) (Fenwick tree).
+// All ranges are half-open: RangeSum(begin, end) is the sum of elements with indices in [begin, end).
+class RangeSumIndex {
+ public:
+  RangeSumIndex() = default;
+  explicit RangeSumIndex(size_t size);
+  // Builds the index in O(n), values are widened to int64 like in Sum.
+  explicit RangeSumIndex(std::span<const int> values);
+
+  size_t Size() const;
+  bool Empty() const;
+
+  int64_t Get(size_t index) const;
+  int64_t PrefixSum(size_t end) const;
+  int64_t RangeSum(size_t begin, size_t end) const;
+
+  void Add(size_t index, int64_t delta);
+  void Set(size_t index, int64_t value);
+
+  // out[i] = RangeSum(ranges[i].first, ranges[i].second). The tree walks of a batch are interleaved, so their cache
+  // misses overlap instead of being paid one after another.
+  void RangeSums(std::span<const std::pair<size_t, size_t>> ranges, std::span<int64_t> out) const;
+  // Equivalent to Add(indices[i], deltas[i]) for every i. Large batches are applied with an O(n) rebuild.
+  void AddMany(std::span<const size_t> indices, std::span<const int64_t> deltas);
+
+ private:
+  void CheckIndex(size_t index) const;
+  void PrefixSums(const size_t* ends, size_t count, int64_t* out) const;
+
+  // 1-based: tree_[i] holds the sum of the (i & -i) elements ending at element i - 1, tree_[0] is unused.
+  std::vector<int64_t> tree_ = std::vector<int64_t>(1);
+};
+
+#endif
@@ -0,0 +1,282 @@
+#include "sum.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <utility>
+#include <vector>
+
+#include "parallel/parallel.hpp"
+
+// Function multiversioning: the compiler emits an AVX2, an SSE4.1 and a generic clone of the kernel and the dynamic
+// loader binds the best one for the running CPU. Elsewhere the generic code is used as is.
+#if defined(__GNUC__) && defined(__x86_64__) && defined(__linux__)
+#define SUM_MULTIVERSION __attribute__((target_clones("avx2", "sse4.1", "default")))
+#else
+#define SUM_MULTIVERSION
+#endif
+
+namespace {
+
+// Independent accumulators let the compiler keep one vector register of wide lanes per group and hide add latency.
+constexpr size_t kLanes = 8;
+
+// int16 lanes are first summed into int32 lanes, which is exact as long as a lane sees less than 2^16 values.
+constexpr size_t kInt16BlockSize = size_t{1} << 16;
+
+constexpr uint64_t kLow32Mask = 0xFFFFFFFF;
+
+template <class Acc, class T>
+inline Acc LaneSum(const T* data, size_t size) {
+  Acc lanes[kLanes] = {};
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    for (size_t j = 0; j < kLanes; ++j) {
+      lanes[j] += data[i + j];
+    }
+  }
+  Acc sum = 0;
+  for (; i < size; ++i) {
+    sum += data[i];
+  }
+  for (size_t j = 0; j < kLanes; ++j) {
+    sum += lanes[j];
+  }
+  return sum;
+}
+
+SUM_MULTIVERSION int64_t SumInt32Kernel(const int* data, size_t size) {
+  return LaneSum<int64_t>(data, size);
+}
+
+SUM_MULTIVERSION int64_t SumInt16Kernel(const int16_t* data, size_t size) {
+  int64_t sum = 0;
+  for (size_t i = 0; i < size; i += kInt16BlockSize) {
+    const auto block = size - i < kInt16BlockSize ? size - i : kInt16BlockSize;
+    sum += LaneSum<int32_t>(data + i, block);
+  }
+  return sum;
+}
+
+// Every int64 is split into a signed high and an unsigned low 32-bit half, so both halves can be summed in 64-bit
+// lanes without overflow and recombined exactly at the end.
+SUM_MULTIVERSION void SumInt64Kernel(const int64_t* data, size_t size, int64_t* high, uint64_t* low) {
+  int64_t high_lanes[kLanes] = {};
+  uint64_t low_lanes[kLanes] = {};
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    for (size_t j = 0; j < kLanes; ++j) {
+      high_lanes[j] += data[i + j] >> 32;
+      low_lanes[j] += static_cast<uint64_t>(data[i + j]) & kLow32Mask;
+    }
+  }
+  for (; i < size; ++i) {
+    *high += data[i] >> 32;
+    *low += static_cast<uint64_t>(data[i]) & kLow32Mask;
+  }
+  for (size_t j = 0; j < kLanes; ++j) {
+    *high += high_lanes[j];
+    *low += low_lanes[j];
+  }
+}
+
+// Scans blocks of kLanes values with a log-step (Hillis-Steele) prefix sum over wide lanes, so the only loop-carried
+// dependency is one add of the running carry per block instead of one per element.
+template <bool kInclusive>
+inline void ScanBlocks(const int* data, size_t size, int64_t carry, int64_t* out) {
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    int64_t lanes[kLanes];
+    for (size_t j = 0; j < kLanes; ++j) {
+      lanes[j] = data[i + j];
+    }
+    for (size_t shift = 1; shift < kLanes; shift *= 2) {
+      for (size_t j = kLanes - 1; j >= shift; --j) {
+        lanes[j] += lanes[j - shift];
+      }
+    }
+    for (size_t j = 0; j < kLanes; ++j) {
+      out[i + j] = carry + (kInclusive ? lanes[j] : lanes[j] - data[i + j]);
+    }
+    carry += lanes[kLanes - 1];
+  }
+  for (; i < size; ++i) {
+    if constexpr (kInclusive) {
+      carry += data[i];
+      out[i] = carry;
+    } else {
+      out[i] = carry;
+      carry += data[i];
+    }
+  }
+}
+
+SUM_MULTIVERSION void InclusiveScanKernel(const int* data, size_t size, int64_t carry, int64_t* out) {
+  ScanBlocks<true>(data, size, carry, out);
+}
+
+SUM_MULTIVERSION void ExclusiveScanKernel(const int* data, size_t size, int64_t carry, int64_t* out) {
+  ScanBlocks<false>(data, size, carry, out);
+}
+
+// Squares of ints are below 2^62. They are summed as high and low 32-bit halves in 64-bit lanes, which is exact for any
+// block shorter than kStatsBlockSize values.
+constexpr size_t kStatsBlockSize = size_t{1} << 31;
+
+SUM_MULTIVERSION void StatsKernel(const int* data, size_t size, SumStats* stats) {
+  int64_t sum_lanes[kLanes] = {};
+  int min_lanes[kLanes];
+  int max_lanes[kLanes];
+  [[maybe_unused]] uint64_t square_high_lanes[kLanes] = {};
+  [[maybe_unused]] uint64_t square_low_lanes[kLanes] = {};
+  for (size_t j = 0; j < kLanes; ++j) {
+    min_lanes[j] = stats->min;
+    max_lanes[j] = stats->max;
+  }
+  const auto add = [&](size_t lane, int value) {
+    sum_lanes[lane] += value;
+    min_lanes[lane] = value < min_lanes[lane] ? value : min_lanes[lane];
+    max_lanes[lane] = value > max_lanes[lane] ? value : max_lanes[lane];
+#ifdef __SIZEOF_INT128__
+    const auto square = static_cast<uint64_t>(int64_t{value} * value);
+    square_high_lanes[lane] += square >> 32;
+    square_low_lanes[lane] += square & kLow32Mask;
+#endif
+  };
+  size_t i = 0;
+  for (; i + kLanes <= size; i += kLanes) {
+    for (size_t j = 0; j < kLanes; ++j) {
+      add(j, data[i + j]);
+    }
+  }
+  for (; i < size; ++i) {
+    add(0, data[i]);
+  }
+  stats->count += static_cast<int64_t>(size);
+  for (size_t j = 0; j < kLanes; ++j) {
+    stats->sum += sum_lanes[j];
+    stats->min = std::min(stats->min, min_lanes[j]);
+    stats->max = std::max(stats->max, max_lanes[j]);
+#ifdef __SIZEOF_INT128__
+    stats->sum_squares += (static_cast<Int128>(square_high_lanes[j]) << 32) + square_low_lanes[j];
+#endif
+  }
+}
+
+using ScanKernel = void (*)(const int*, size_t, int64_t, int64_t*);
+
+// Pass 1 sums the chunks independently, a short serial scan over the chunk sums gives every chunk its starting carry,
+// and pass 2 scans the chunks independently again.
+void Scan(std::span<const int> values, std::span<int64_t> out, size_t num_threads, ScanKernel kernel) {
+  if (values.size() != out.size()) {
+    throw SumSizeMismatch{};
+  }
+  if (values.size() < kParallelScanThreshold) {
+    kernel(values.data(), values.size(), 0, out.data());
+    return;
+  }
+  const auto num_chunks = (values.size() + kDefaultSumGrain - 1) / kDefaultSumGrain;
+  const auto chunk = [&](size_t index) {
+    const auto begin = index * kDefaultSumGrain;
+    return values.subspan(begin, std::min(kDefaultSumGrain, values.size() - begin));
+  };
+  std::vector<int64_t> carries(num_chunks);
+  parallel_internal::ParallelFor(num_chunks, num_threads, [&](size_t index) {
+    carries[index] = SumRange(chunk(index));
+  });
+  int64_t carry = 0;
+  for (auto& chunk_carry : carries) {
+    carry += std::exchange(chunk_carry, carry);
+  }
+  parallel_internal::ParallelFor(num_chunks, num_threads, [&](size_t index) {
+    const auto values_chunk = chunk(index);
+    kernel(values_chunk.data(), values_chunk.size(), carries[index], out.data() + index * kDefaultSumGrain);
+  });
+}
+
+}  // namespace
+
+int64_t Sum(int x, int y) {
+  return int64_t{x} + y;
+}
+
+int64_t SumRange(std::span<const int> values) {
+  return SumInt32Kernel(values.data(), values.size());
+}
+
+int64_t SumRange(std::span<const int16_t> values) {
+  return SumInt16Kernel(values.data(), values.size());
+}
+
+int64_t SumRange(std::span<const int64_t> values) {
+  int64_t high = 0;
+  uint64_t low = 0;
+  SumInt64Kernel(values.data(), values.size(), &high, &low);
+  high += static_cast<int64_t>(low >> 32);
+  low &= kLow32Mask;
+  if (high < std::numeric_limits<int32_t>::min() || high > std::numeric_limits<int32_t>::max()) {
+    throw SumOverflow{};
+  }
+  return static_cast<int64_t>(static_cast<uint64_t>(high) << 32 | low);
+}
+
+int64_t SumParallel(std::span<const int> values, size_t grain, size_t num_threads) {
+  grain = std::max<size_t>(grain, 1);
+  const auto num_chunks = (values.size() + grain - 1) / grain;
+  if (num_chunks <= 1) {
+    return SumRange(values);
+  }
+  std::vector<int64_t> partial_sums(num_chunks);
+  parallel_internal::ParallelFor(num_chunks, num_threads, [&](size_t chunk) {
+    partial_sums[chunk] = SumRange(values.subspan(chunk * grain, std::min(grain, values.size() - chunk * grain)));
+  });
+  return SumRange(std::span<const int64_t>(partial_sums));
+}
+
+void InclusiveScan(std::span<const int> values, std::span<int64_t> out, size_t num_threads) {
+  Scan(values, out, num_threads, InclusiveScanKernel);
+}
+
+void ExclusiveScan(std::span<const int> values, std::span<int64_t> out, size_t num_threads) {
+  Scan(values, out, num_threads, ExclusiveScanKernel);
+}
+
+void SumStats::Add(int value) {
+  ++count;
+  sum += value;
+  min = std::min(min, value);
+  max = std::max(max, value);
+#ifdef __SIZEOF_INT128__
+  sum_squares += int64_t{value} * value;
+#endif
+}
+
+void SumStats::Add(std::span<const int> values) {
+  for (size_t i = 0; i < values.size(); i += kStatsBlockSize) {
+    StatsKernel(values.data() + i, std::min(kStatsBlockSize, values.size() - i), this);
+  }
+}
+
+void SumStats::Merge(const SumStats& other) {
+  count += other.count;
+  sum += other.sum;
+  min = std::min(min, other.min);
+  max = std::max(max, other.max);
+#ifdef __SIZEOF_INT128__
+  sum_squares += other.sum_squares;
+#endif
+}
+
+SumStats SumStatsParallel(std::span<const int> values, size_t grain, size_t num_threads) {
+  grain = std::max<size_t>(grain, 1);
+  const auto num_chunks = (values.size() + grain - 1) / grain;
+  std::vector<SumStats> partial_stats(num_chunks);
+  parallel_internal::ParallelFor(num_chunks, num_threads, [&](size_t chunk) {
+    partial_stats[chunk].Add(values.subspan(chunk * grain, std::min(grain, values.size() - chunk * grain)));
+  });
+  SumStats stats;
+  for (const auto& partial : partial_stats) {
+    stats.Merge(partial);
+  }
+  return stats;
+}
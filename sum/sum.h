@@ -1 +1,77 @@
-// Sum(int, int)
\ No newline at end of file
+#pragma once
+#ifndef SUM_H
+#define SUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <stdexcept>
+
+class SumOverflow : public std::overflow_error {
+ public:
+  SumOverflow() : std::overflow_error("SumOverflow") {
+  }
+};
+
+class SumSizeMismatch : public std::invalid_argument {
+ public:
+  SumSizeMismatch() : std::invalid_argument("SumSizeMismatch") {
+  }
+};
+
+// Mathematically exact sum of two ints.
+int64_t Sum(int x, int y);
+
+// Exact sum of all elements. Kernels widen lanes to int64 and are picked at runtime (AVX2/SSE4.1/generic).
+// For int and int16_t spans the result is exact for any span shorter than 2^32 elements.
+int64_t SumRange(std::span<const int> values);
+int64_t SumRange(std::span<const int16_t> values);
+// Throws SumOverflow if the exact sum does not fit into int64_t.
+int64_t SumRange(std::span<const int64_t> values);
+
+// 64K ints (256 KiB) per chunk: large enough to amortize scheduling, small enough to stay in L2.
+inline constexpr size_t kDefaultSumGrain = size_t{1} << 16;
+
+// Exact sum computed on num_threads threads (0 means one per hardware thread). The span is split into chunks of grain
+// elements that idle threads pick up dynamically; chunk boundaries do not depend on the number of threads, so the
+// result is always the same as SumRange(values).
+int64_t SumParallel(std::span<const int> values, size_t grain = kDefaultSumGrain, size_t num_threads = 0);
+
+// Inputs of at least this many elements are scanned by several threads.
+inline constexpr size_t kParallelScanThreshold = size_t{1} << 20;
+
+// Exact int64 prefix sums: out[i] = values[0] + ... + values[i] for the inclusive scan and
+// out[i] = values[0] + ... + values[i - 1] (out[0] = 0) for the exclusive one. Large spans are scanned in two passes
+// on num_threads threads (0 means one per hardware thread). Throws SumSizeMismatch if out.size() != values.size().
+void InclusiveScan(std::span<const int> values, std::span<int64_t> out, size_t num_threads = 0);
+void ExclusiveScan(std::span<const int> values, std::span<int64_t> out, size_t num_threads = 0);
+
+#ifdef __SIZEOF_INT128__
+__extension__ using Int128 = __int128;
+#endif
+
+// Count, exact sum, min, max and (with compilers that have a 128-bit integer type) exact sum of squares of ints.
+// States of disjoint parts of the data can be merged in any order, e.g. one per thread or one per incoming block.
+// An empty state has min == INT_MAX and max == INT_MIN, the identity elements of min and max.
+struct SumStats {
+  int64_t count = 0;
+  int64_t sum = 0;
+  int min = std::numeric_limits<int>::max();
+  int max = std::numeric_limits<int>::min();
+#ifdef __SIZEOF_INT128__
+  Int128 sum_squares = 0;
+#endif
+
+  void Add(int value);
+  // Updates all statistics in a single vectorized pass over values.
+  void Add(std::span<const int> values);
+  void Merge(const SumStats& other);
+
+  bool operator==(const SumStats& other) const = default;
+};
+
+// SumStats of the whole span computed chunk by chunk on num_threads threads, see SumParallel.
+SumStats SumStatsParallel(std::span<const int> values, size_t grain = kDefaultSumGrain, size_t num_threads = 0);
+
+#endif
@@ -0,0 +1,42 @@
+// Usage: sum_cli FILE [THREADS]
+// Prints the exact int64 sum of a raw little-endian int32 file. The file is memory-mapped window by window, so it is
+// never copied into the process and the resident memory does not grow with the file size.
+
+#include <charconv>
+#include <cstddef>
+#include <iostream>
+#include <string>
+#include <string_view>
+
+#include "file_sum.h"
+
+namespace {
+
+int Fail(const std::string& message) {
+  std::cerr << "sum_cli: " << message << '\n';
+  return 1;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  if (argc != 2 && argc != 3) {
+    std::cerr << "usage: sum_cli FILE [THREADS]\n";
+    return 2;
+  }
+  size_t num_threads = 0;
+  if (argc == 3) {
+    const std::string_view arg = argv[2];
+    const auto [end, error] = std::from_chars(arg.data(), arg.data() + arg.size(), num_threads);
+    if (error != std::errc{} || end != arg.data() + arg.size()) {
+      return Fail("invalid thread count: " + std::string(arg));
+    }
+  }
+
+  try {
+    std::cout << SumInt32File(argv[1], std::endian::little, num_threads) << '\n';
+  } catch (const SumFileError& error) {
+    return Fail(error.what());
+  }
+  return 0;
+}
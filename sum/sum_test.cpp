@@ -3,8 +3,29 @@
 
 #include "sum.h"
 #include "sum.h"  // check include guards
+#include "delta_varint.h"
+#include "delta_varint.h"  // check include guards
+#include "grouped_sum.h"
+#include "grouped_sum.h"  // check include guards
+#include "range_sum.h"
+#include "range_sum.h"  // check include guards
+#include "windowed_sum.h"
+#include "windowed_sum.h"  // check include guards
+#if defined(__unix__) || defined(__APPLE__)
+#include "file_sum.h"
+#include "file_sum.h"  // check include guards
+#define SUM_TEST_FILE_SUM
+#endif
 
+#include <bit>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
 #include <limits>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
 
 template <class F, class... Args>
 inline constexpr auto kTakesArguments = false;
@@ -56,3 +77,511 @@ TEST_CASE("MixLarge", "[Sum]") {
   REQUIRE(Sum(5, -kMaxInt) == int64_t{-kMaxInt} + int64_t{5});
   REQUIRE(Sum(kMaxInt, -5) == int64_t{-5} + int64_t{kMaxInt});
 }
+
+TEST_CASE("SumRangeEmpty", "[SumRange]") {
+  REQUIRE(SumRange(std::span<const int>{}) == 0);
+  REQUIRE(SumRange(std::span<const int16_t>{}) == 0);
+  REQUIRE(SumRange(std::span<const int64_t>{}) == 0);
+}
+
+TEST_CASE("SumRangeMatchesSum", "[SumRange]") {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), kMaxInt);
+  for (size_t size : {1, 7, 8, 9, 63, 1000, 4097}) {
+    std::vector<int> values(size);
+    int64_t expected = 0;
+    for (auto& value : values) {
+      value = dist(gen);
+      expected += value;
+    }
+    REQUIRE(SumRange(values) == expected);
+  }
+}
+
+TEST_CASE("SumRangeLarge", "[SumRange]") {
+  const std::vector<int> max_values(100003, kMaxInt);
+  REQUIRE(SumRange(max_values) == int64_t{kMaxInt} * 100003);
+  const std::vector<int> min_values(100003, std::numeric_limits<int>::min());
+  REQUIRE(SumRange(min_values) == int64_t{std::numeric_limits<int>::min()} * 100003);
+}
+
+TEST_CASE("SumRangeInt16", "[SumRange]") {
+  const std::vector<int16_t> max_values(200001, std::numeric_limits<int16_t>::max());
+  REQUIRE(SumRange(max_values) == int64_t{std::numeric_limits<int16_t>::max()} * 200001);
+  const std::vector<int16_t> mixed{-5, 7, std::numeric_limits<int16_t>::min(), 1};
+  REQUIRE(SumRange(mixed) == int64_t{std::numeric_limits<int16_t>::min()} + 3);
+}
+
+TEST_CASE("SumRangeInt64", "[SumRange]") {
+  constexpr auto kMax = std::numeric_limits<int64_t>::max();
+  constexpr auto kMin = std::numeric_limits<int64_t>::min();
+  REQUIRE(SumRange(std::vector<int64_t>{kMax, -1, 1}) == kMax);
+  REQUIRE(SumRange(std::vector<int64_t>{kMax, kMax, kMin, kMin, 5, -3}) == 0);
+  REQUIRE(SumRange(std::vector<int64_t>{kMin, -7, 7}) == kMin);
+  REQUIRE(SumRange(std::vector<int64_t>(17, -3)) == -51);
+  REQUIRE_THROWS_AS(SumRange(std::vector<int64_t>{kMax, 1}), SumOverflow);
+  REQUIRE_THROWS_AS(SumRange(std::vector<int64_t>(9, kMin)), SumOverflow);
+}
+
+TEST_CASE("SumParallel", "[SumParallel]") {
+  std::mt19937 gen(7);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), kMaxInt);
+  std::vector<int> values(300007);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  const auto expected = SumRange(values);
+  for (size_t num_threads : {1, 2, 3, 8}) {
+    for (size_t grain : {1000, 4096, 65536, 1000000}) {
+      REQUIRE(SumParallel(values, grain, num_threads) == expected);
+    }
+  }
+  REQUIRE(SumParallel(values) == expected);
+  REQUIRE(SumParallel(values, 0) == expected);
+}
+
+TEST_CASE("SumParallelSmall", "[SumParallel]") {
+  REQUIRE(SumParallel(std::span<const int>{}) == 0);
+  REQUIRE(SumParallel(std::vector<int>{kMaxInt, kMaxInt, kMaxInt}, 1, 4) == int64_t{kMaxInt} * 3);
+}
+
+TEST_CASE("ScanSmall", "[Scan]") {
+  const std::vector<int> values{3, -1, kMaxInt, kMaxInt, -7};
+  std::vector<int64_t> out(values.size());
+  InclusiveScan(values, out);
+  REQUIRE(out == std::vector<int64_t>{3, 2, int64_t{kMaxInt} + 2, int64_t{kMaxInt} * 2 + 2, int64_t{kMaxInt} * 2 - 5});
+  ExclusiveScan(values, out);
+  REQUIRE(out == std::vector<int64_t>{0, 3, 2, int64_t{kMaxInt} + 2, int64_t{kMaxInt} * 2 + 2});
+  InclusiveScan(std::span<const int>{}, std::span<int64_t>{});
+}
+
+TEST_CASE("ScanMatchesSerialLoop", "[Scan]") {
+  std::mt19937 gen(11);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), kMaxInt);
+  for (size_t size : {1, 8, 17, 1000, (1 << 20) + 12345}) {
+    std::vector<int> values(size);
+    for (auto& value : values) {
+      value = dist(gen);
+    }
+    std::vector<int64_t> inclusive(size);
+    std::vector<int64_t> exclusive(size);
+    int64_t sum = 0;
+    for (size_t i = 0; i < size; ++i) {
+      exclusive[i] = sum;
+      sum += values[i];
+      inclusive[i] = sum;
+    }
+    for (size_t num_threads : {1, 3}) {
+      std::vector<int64_t> out(size);
+      InclusiveScan(values, out, num_threads);
+      REQUIRE(out == inclusive);
+      ExclusiveScan(values, out, num_threads);
+      REQUIRE(out == exclusive);
+    }
+  }
+}
+
+TEST_CASE("ScanSizeMismatch", "[Scan]") {
+  const std::vector<int> values(4);
+  std::vector<int64_t> out(3);
+  REQUIRE_THROWS_AS(InclusiveScan(values, out), SumSizeMismatch);
+  REQUIRE_THROWS_AS(ExclusiveScan(values, out), SumSizeMismatch);
+}
+
+TEST_CASE("RangeSumIndex", "[RangeSumIndex]") {
+  const std::vector<int> values{5, kMaxInt, -3, kMaxInt, 0, -kMaxInt, 9};
+  auto index = RangeSumIndex(values);
+  REQUIRE(index.Size() == values.size());
+  REQUIRE_FALSE(index.Empty());
+  for (size_t begin = 0; begin <= values.size(); ++begin) {
+    for (auto end = begin; end <= values.size(); ++end) {
+      int64_t expected = 0;
+      for (auto i = begin; i < end; ++i) {
+        expected += values[i];
+      }
+      REQUIRE(index.RangeSum(begin, end) == expected);
+    }
+  }
+  for (size_t i = 0; i < values.size(); ++i) {
+    REQUIRE(index.Get(i) == values[i]);
+  }
+
+  index.Add(1, kMaxInt);
+  REQUIRE(index.Get(1) == int64_t{kMaxInt} * 2);
+  index.Set(3, -1);
+  REQUIRE(index.Get(3) == -1);
+  REQUIRE(index.PrefixSum(7) == 5 + int64_t{kMaxInt} * 2 - 3 - 1 + 0 - kMaxInt + 9);
+
+  REQUIRE_THROWS_AS(index.Get(7), RangeSumOutOfRange);
+  REQUIRE_THROWS_AS(index.Add(7, 1), RangeSumOutOfRange);
+  REQUIRE_THROWS_AS(index.RangeSum(3, 2), RangeSumOutOfRange);
+  REQUIRE_THROWS_AS(index.RangeSum(0, 8), RangeSumOutOfRange);
+  REQUIRE(RangeSumIndex().Empty());
+  REQUIRE(RangeSumIndex(5).RangeSum(0, 5) == 0);
+}
+
+TEST_CASE("RangeSumIndexBatched", "[RangeSumIndex]") {
+  std::mt19937 gen(5);
+  std::uniform_int_distribution<int> value_dist(-1000, 1000);
+  std::vector<int64_t> naive(1000);
+  std::vector<int> values(naive.size());
+  for (size_t i = 0; i < values.size(); ++i) {
+    naive[i] = values[i] = value_dist(gen);
+  }
+  auto index = RangeSumIndex(values);
+  std::uniform_int_distribution<size_t> index_dist(0, naive.size() - 1);
+
+  for (size_t batch_size : {3, 50, 5000}) {
+    std::vector<size_t> indices(batch_size);
+    std::vector<int64_t> deltas(batch_size);
+    for (size_t j = 0; j < batch_size; ++j) {
+      indices[j] = index_dist(gen);
+      deltas[j] = value_dist(gen);
+      naive[indices[j]] += deltas[j];
+    }
+    index.AddMany(indices, deltas);
+
+    std::vector<std::pair<size_t, size_t>> ranges(batch_size);
+    for (auto& [begin, end] : ranges) {
+      begin = index_dist(gen);
+      end = index_dist(gen);
+      if (begin > end) {
+        std::swap(begin, end);
+      }
+    }
+    std::vector<int64_t> out(batch_size);
+    index.RangeSums(ranges, out);
+    for (size_t j = 0; j < batch_size; ++j) {
+      int64_t expected = 0;
+      for (auto i = ranges[j].first; i < ranges[j].second; ++i) {
+        expected += naive[i];
+      }
+      REQUIRE(out[j] == expected);
+    }
+  }
+
+  std::vector<int64_t> out(1);
+  REQUIRE_THROWS_AS(index.RangeSums(std::vector<std::pair<size_t, size_t>>(2), out), SumSizeMismatch);
+  REQUIRE_THROWS_AS(index.AddMany(std::vector<size_t>{1000}, std::vector<int64_t>{1}), RangeSumOutOfRange);
+}
+
+TEST_CASE("GroupedSum", "[GroupedSum]") {
+  GroupedSum table;
+  REQUIRE(table.Empty());
+  REQUIRE(table.Get(1) == 0);
+  table.Add(std::vector<int>{1, -2, 1, kMaxInt, 1}, std::vector<int>{kMaxInt, 5, kMaxInt, -1, kMaxInt});
+  REQUIRE(table.Size() == 3);
+  REQUIRE(table.Get(1) == int64_t{kMaxInt} * 3);
+  REQUIRE(table.Get(-2) == 5);
+  REQUIRE(table.Contains(kMaxInt));
+  REQUIRE_FALSE(table.Contains(0));
+
+  GroupedSum other;
+  other.Add(0, 4);
+  other.Add(-2, -5);
+  table.Merge(other);
+  using Items = std::vector<std::pair<int, int64_t>>;
+  REQUIRE(table.Items() == Items{{-2, 0}, {0, 4}, {1, int64_t{kMaxInt} * 3}, {kMaxInt, -1}});
+  REQUIRE_THROWS_AS(table.Add(std::vector<int>(2), std::vector<int>(3)), SumSizeMismatch);
+}
+
+TEST_CASE("GroupedSumMergeAtGrowthThreshold", "[GroupedSum]") {
+  // Tables holding exactly 7/8 of their capacity grow on the next new key, but not when existing keys are updated.
+  for (int size : {14, 28, 56, 112, 224, 448}) {
+    GroupedSum table;
+    for (int key = 1; key <= size; ++key) {
+      table.Add(key, key);
+    }
+    const auto copy = table;
+    table.Merge(table);
+    table.Merge(copy);
+    REQUIRE(table.Size() == static_cast<size_t>(size));
+    int64_t total = 0;
+    for (const auto& [key, sum] : table.Items()) {
+      REQUIRE(sum == int64_t{3} * key);
+      total += sum;
+    }
+    REQUIRE(total == int64_t{3} * size * (size + 1) / 2);
+  }
+}
+
+TEST_CASE("GroupedSumMatchesMap", "[GroupedSum]") {
+  std::mt19937 gen(3);
+  std::uniform_int_distribution<int> value_dist(std::numeric_limits<int>::min(), kMaxInt);
+  for (int num_keys : {10, 5000, 1000000}) {
+    std::uniform_int_distribution<int> key_dist(-num_keys, num_keys);
+    std::vector<int> keys(300000);
+    std::vector<int> values(keys.size());
+    std::map<int, int64_t> expected;
+    for (size_t i = 0; i < keys.size(); ++i) {
+      keys[i] = key_dist(gen);
+      values[i] = value_dist(gen);
+      expected[keys[i]] += values[i];
+    }
+    const std::vector<std::pair<int, int64_t>> expected_items(expected.begin(), expected.end());
+
+    GroupedSum table;
+    table.Add(keys, values);
+    REQUIRE(table.Size() == expected.size());
+    REQUIRE(table.Items() == expected_items);
+    for (size_t num_threads : {1, 2, 5}) {
+      REQUIRE(GroupedSumParallel(keys, values, num_threads) == expected_items);
+    }
+  }
+}
+
+TEST_CASE("DeltaVarintRoundTrip", "[DeltaVarint]") {
+  std::mt19937 gen(9);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), kMaxInt);
+  for (size_t size : {0, 1, 3, 4, 5, 1001}) {
+    std::vector<int> values(size);
+    for (auto& value : values) {
+      value = dist(gen);
+    }
+    const auto encoded = EncodeDeltaVarint(values);
+    REQUIRE(DecodeDeltaVarint(encoded) == values);
+    REQUIRE(SumDeltaVarint(encoded) == SumRange(values));
+  }
+
+  const std::vector<int> extremes{std::numeric_limits<int>::min(), kMaxInt, 0, -1, kMaxInt, kMaxInt, 1};
+  const auto encoded = EncodeDeltaVarint(extremes);
+  REQUIRE(DecodeDeltaVarint(encoded) == extremes);
+  REQUIRE(SumDeltaVarint(encoded) == SumRange(extremes));
+}
+
+TEST_CASE("DeltaVarintCompressesSmallDeltas", "[DeltaVarint]") {
+  std::vector<int> counters(10000);
+  for (size_t i = 1; i < counters.size(); ++i) {
+    counters[i] = counters[i - 1] + static_cast<int>(i % 100) - 40;
+  }
+  const auto encoded = EncodeDeltaVarint(counters);
+  REQUIRE(encoded.size() < counters.size() * sizeof(int) / 3);
+  REQUIRE(DecodeDeltaVarint(encoded) == counters);
+  REQUIRE(SumDeltaVarint(encoded) == SumRange(counters));
+}
+
+TEST_CASE("DeltaVarintCorrupted", "[DeltaVarint]") {
+  const auto encoded = EncodeDeltaVarint(std::vector<int>{1, 1000, -100000, 7, 8});
+  REQUIRE_THROWS_AS(SumDeltaVarint(std::span(encoded).first(encoded.size() - 1)), DeltaVarintCorrupted);
+  REQUIRE_THROWS_AS(DecodeDeltaVarint(std::span(encoded).first(5)), DeltaVarintCorrupted);
+
+  auto longer = encoded;
+  longer.push_back(0);
+  REQUIRE_THROWS_AS(DecodeDeltaVarint(longer), DeltaVarintCorrupted);
+
+  auto wrong_count = encoded;
+  wrong_count[7] = 0xFF;
+  REQUIRE_THROWS_AS(SumDeltaVarint(wrong_count), DeltaVarintCorrupted);
+}
+
+TEST_CASE("SumStats", "[SumStats]") {
+  SumStats stats;
+  REQUIRE(stats.count == 0);
+  REQUIRE(stats.min == kMaxInt);
+  REQUIRE(stats.max == std::numeric_limits<int>::min());
+
+  stats.Add(std::vector<int>{3, -7, kMaxInt, 0, 12, -kMaxInt, 5, 5, 1});
+  REQUIRE(stats.count == 9);
+  REQUIRE(stats.sum == 19);
+  REQUIRE(stats.min == -kMaxInt);
+  REQUIRE(stats.max == kMaxInt);
+#ifdef __SIZEOF_INT128__
+  REQUIRE(stats.sum_squares == Int128{kMaxInt} * kMaxInt * 2 + 9 + 49 + 144 + 25 + 25 + 1);
+#endif
+
+  stats.Add(std::numeric_limits<int>::min());
+  REQUIRE(stats.min == std::numeric_limits<int>::min());
+  REQUIRE(stats.count == 10);
+}
+
+TEST_CASE("SumStatsMerge", "[SumStats]") {
+  std::mt19937 gen(13);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), kMaxInt);
+  std::vector<int> values(200003);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  SumStats expected;
+  for (const auto value : values) {
+    expected.count += 1;
+    expected.sum += value;
+    expected.min = std::min(expected.min, value);
+    expected.max = std::max(expected.max, value);
+#ifdef __SIZEOF_INT128__
+    expected.sum_squares += Int128{value} * value;
+#endif
+  }
+
+  SumStats single_pass;
+  single_pass.Add(values);
+  REQUIRE(single_pass == expected);
+
+  SumStats left;
+  SumStats right;
+  left.Add(std::span(values).first(1000));
+  right.Add(std::span(values).subspan(1000));
+  left.Merge(right);
+  REQUIRE(left == expected);
+
+  REQUIRE(SumStatsParallel(values, 4096, 3) == expected);
+  REQUIRE(SumStatsParallel(values) == expected);
+  REQUIRE(SumStatsParallel(std::span<const int>{}) == SumStats{});
+}
+
+TEST_CASE("WindowedSum", "[WindowedSum]") {
+  WindowedSum window(3);
+  REQUIRE(window.Window() == 3);
+  window.Push(kMaxInt);
+  window.Push(kMaxInt);
+  REQUIRE(window.Sum() == int64_t{kMaxInt} * 2);
+  REQUIRE(window.Size() == 2);
+  window.Push(kMaxInt);
+  window.Push(-1);
+  REQUIRE(window.Sum() == int64_t{kMaxInt} * 2 - 1);
+  REQUIRE(window.Size() == 3);
+  window.Clear();
+  REQUIRE(window.Sum() == 0);
+  REQUIRE(window.Size() == 0);
+
+  WindowedSum empty(0);
+  empty.Push(5);
+  empty.Push(std::vector<int>{1, 2});
+  REQUIRE(empty.Sum() == 0);
+}
+
+TEST_CASE("WindowedSumBatched", "[WindowedSum]") {
+  std::mt19937 gen(17);
+  std::uniform_int_distribution<int> value_dist(std::numeric_limits<int>::min(), kMaxInt);
+  std::uniform_int_distribution<size_t> batch_dist(0, 40);
+  for (size_t window_size : {1, 5, 16, 30}) {
+    WindowedSum window(window_size);
+    std::vector<int> history;
+    for (int step = 0; step < 200; ++step) {
+      std::vector<int> batch(batch_dist(gen));
+      for (auto& value : batch) {
+        value = value_dist(gen);
+      }
+      if (step % 3 == 0) {
+        for (const auto value : batch) {
+          window.Push(value);
+        }
+      } else {
+        window.Push(batch);
+      }
+      history.insert(history.end(), batch.begin(), batch.end());
+      const auto size = std::min(window_size, history.size());
+      REQUIRE(window.Size() == size);
+      REQUIRE(window.Sum() == SumRange(std::span(history).last(size)));
+    }
+  }
+}
+
+TEST_CASE("TimeWindowedSum", "[WindowedSum]") {
+  TimeWindowedSum window(10);
+  REQUIRE(window.Duration() == 10);
+  window.Push(0, kMaxInt);
+  window.Push(5, kMaxInt);
+  window.Push(5, 1);
+  REQUIRE(window.Sum() == int64_t{kMaxInt} * 2 + 1);
+  window.Advance(10);
+  REQUIRE(window.Sum() == int64_t{kMaxInt} + 1);
+  REQUIRE(window.Size() == 2);
+  window.Push(std::vector<int64_t>{12, 14, 15, 30}, std::vector<int>{1, 2, 3, 4});
+  REQUIRE(window.Sum() == 4);
+  REQUIRE(window.Size() == 1);
+  window.Advance(39);
+  REQUIRE(window.Sum() == 4);
+  window.Advance(40);
+  REQUIRE(window.Sum() == 0);
+  REQUIRE(window.Size() == 0);
+
+  REQUIRE_THROWS_AS(window.Push(39, 1), WindowedSumOutOfOrder);
+  REQUIRE_THROWS_AS(window.Push(std::vector<int64_t>{41, 40}, std::vector<int>{1, 2}), WindowedSumOutOfOrder);
+  REQUIRE_THROWS_AS(window.Push(std::vector<int64_t>{41}, std::vector<int>{1, 2}), SumSizeMismatch);
+  window.Clear();
+  window.Push(std::numeric_limits<int64_t>::min(), 7);
+  REQUIRE(window.Sum() == 7);
+}
+
+TEST_CASE("TimeWindowedSumBatched", "[WindowedSum]") {
+  std::mt19937 gen(19);
+  std::uniform_int_distribution<int> value_dist(-1000, 1000);
+  std::uniform_int_distribution<int64_t> step_dist(0, 3);
+  std::uniform_int_distribution<size_t> batch_dist(0, 50);
+  TimeWindowedSum window(25);
+  std::vector<std::pair<int64_t, int>> history;
+  int64_t now = 0;
+  for (int step = 0; step < 300; ++step) {
+    std::vector<int64_t> timestamps(batch_dist(gen));
+    std::vector<int> values(timestamps.size());
+    for (size_t i = 0; i < timestamps.size(); ++i) {
+      now += step_dist(gen);
+      timestamps[i] = now;
+      values[i] = value_dist(gen);
+      history.emplace_back(now, values[i]);
+    }
+    window.Push(timestamps, values);
+    int64_t expected = 0;
+    size_t expected_size = 0;
+    for (const auto& [timestamp, value] : history) {
+      if (timestamp > now - 25) {
+        expected += value;
+        ++expected_size;
+      }
+    }
+    REQUIRE(window.Sum() == expected);
+    REQUIRE(window.Size() == expected_size);
+  }
+}
+
+#ifdef SUM_TEST_FILE_SUM
+// Writes values as raw int32 in the given byte order and returns the path of the file.
+std::string WriteInt32File(const std::string& name, const std::vector<int>& values, std::endian byte_order) {
+  const auto path = (std::filesystem::temp_directory_path() / name).string();
+  std::ofstream file(path, std::ios::binary | std::ios::trunc);
+  for (const auto value : values) {
+    const auto bits = static_cast<uint32_t>(value);
+    for (int byte = 0; byte < 4; ++byte) {
+      const auto shift = byte_order == std::endian::little ? 8 * byte : 8 * (3 - byte);
+      file.put(static_cast<char>((bits >> shift) & 0xFF));
+    }
+  }
+  return path;
+}
+
+TEST_CASE("SumInt32File", "[SumInt32File]") {
+  // A 64 KiB window is a multiple of the usual page sizes; 40000 values cross two window boundaries and end in a
+  // partial window.
+  constexpr size_t kWindowSize = size_t{64} << 10;
+  std::mt19937 gen(23);
+  std::uniform_int_distribution<int> dist(std::numeric_limits<int>::min(), kMaxInt);
+  std::vector<int> values(40000);
+  for (auto& value : values) {
+    value = dist(gen);
+  }
+  values[kWindowSize / 4 - 1] = kMaxInt;
+  values[kWindowSize / 4] = kMaxInt;
+  int64_t expected = 0;
+  for (const auto value : values) {
+    expected += value;
+  }
+  for (const auto byte_order : {std::endian::little, std::endian::big}) {
+    const auto path = WriteInt32File(byte_order == std::endian::little ? "sum_test_le.bin" : "sum_test_be.bin",
+                                     values, byte_order);
+    REQUIRE(SumInt32File(path, byte_order) == expected);
+    for (size_t num_threads : {1, 3}) {
+      REQUIRE(SumInt32File(path, byte_order, num_threads, kWindowSize) == expected);
+    }
+    std::filesystem::remove(path);
+  }
+
+  const auto empty = WriteInt32File("sum_test_empty.bin", {}, std::endian::little);
+  REQUIRE(SumInt32File(empty) == 0);
+  std::filesystem::remove(empty);
+  const auto odd_size = WriteInt32File("sum_test_odd.bin", {1, 2}, std::endian::little);
+  std::filesystem::resize_file(odd_size, 7);
+  REQUIRE_THROWS_AS(SumInt32File(odd_size), SumFileError);
+  std::filesystem::remove(odd_size);
+  REQUIRE_THROWS_AS(SumInt32File(odd_size), SumFileError);
+}
+#endif
@@ -0,0 +1,177 @@
+#include "windowed_sum.h"
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+#include "sum.h"
+
+namespace {
+
+constexpr size_t kMinTimeRingCapacity = 16;
+
+// Sum of count ring elements starting at position begin; the range wraps around at most once.
+int64_t RingSum(const std::vector<int>& ring, size_t begin, size_t count) {
+  const auto first = std::min(count, ring.size() - begin);
+  return SumRange(std::span(ring).subspan(begin, first)) + SumRange(std::span(ring).first(count - first));
+}
+
+template <class T>
+void RingWrite(std::vector<T>& ring, size_t begin, std::span<const T> values) {
+  const auto first = std::min(values.size(), ring.size() - begin);
+  std::copy_n(values.begin(), first, ring.begin() + static_cast<std::ptrdiff_t>(begin));
+  std::copy(values.begin() + static_cast<std::ptrdiff_t>(first), values.end(), ring.begin());
+}
+
+}  // namespace
+
+WindowedSum::WindowedSum(size_t window)
+    : ring_(std::bit_ceil(std::max<size_t>(window, 1))), mask_(ring_.size() - 1), window_(window) {
+}
+
+void WindowedSum::Push(int value) {
+  if (window_ == 0) {
+    return;
+  }
+  if (size_ == window_) {
+    sum_ -= ring_[(head_ - window_) & mask_];
+  } else {
+    ++size_;
+  }
+  ring_[head_] = value;
+  head_ = (head_ + 1) & mask_;
+  sum_ += value;
+}
+
+void WindowedSum::Push(std::span<const int> values) {
+  if (window_ == 0) {
+    return;
+  }
+  if (values.size() >= window_) {
+    values = values.last(window_);
+  }
+  const auto evicted = size_ + values.size() > window_ ? size_ + values.size() - window_ : 0;
+  sum_ += SumRange(values) - RingSum(ring_, (head_ - size_) & mask_, evicted);
+  RingWrite(ring_, head_, values);
+  head_ = (head_ + values.size()) & mask_;
+  size_ += values.size() - evicted;
+}
+
+void WindowedSum::Clear() {
+  head_ = 0;
+  size_ = 0;
+  sum_ = 0;
+}
+
+int64_t WindowedSum::Sum() const {
+  return sum_;
+}
+
+size_t WindowedSum::Size() const {
+  return size_;
+}
+
+size_t WindowedSum::Window() const {
+  return window_;
+}
+
+TimeWindowedSum::TimeWindowedSum(int64_t duration)
+    : duration_(std::max<int64_t>(duration, 0)), now_(std::numeric_limits<int64_t>::min()) {
+}
+
+void TimeWindowedSum::Push(int64_t timestamp, int value) {
+  Push(std::span(&timestamp, 1), std::span(&value, 1));
+}
+
+void TimeWindowedSum::Push(std::span<const int64_t> timestamps, std::span<const int> values) {
+  if (timestamps.size() != values.size()) {
+    throw SumSizeMismatch{};
+  }
+  if (timestamps.empty()) {
+    return;
+  }
+  CheckTime(timestamps.front());
+  if (!std::is_sorted(timestamps.begin(), timestamps.end())) {
+    throw WindowedSumOutOfOrder{};
+  }
+  now_ = timestamps.back();
+  Evict();
+  // Values of the batch that are already outside the window are never stored.
+  if (now_ >= std::numeric_limits<int64_t>::min() + duration_) {
+    const auto expired = std::upper_bound(timestamps.begin(), timestamps.end(), now_ - duration_) - timestamps.begin();
+    timestamps = timestamps.subspan(static_cast<size_t>(expired));
+    values = values.subspan(static_cast<size_t>(expired));
+  }
+  Reserve(size_ + values.size());
+  const auto head = (tail_ + size_) & mask_;
+  RingWrite(timestamps_, head, timestamps);
+  RingWrite(values_, head, values);
+  size_ += values.size();
+  sum_ += SumRange(values);
+}
+
+void TimeWindowedSum::Advance(int64_t now) {
+  CheckTime(now);
+  now_ = now;
+  Evict();
+}
+
+void TimeWindowedSum::Clear() {
+  tail_ = 0;
+  size_ = 0;
+  sum_ = 0;
+  now_ = std::numeric_limits<int64_t>::min();
+}
+
+int64_t TimeWindowedSum::Sum() const {
+  return sum_;
+}
+
+size_t TimeWindowedSum::Size() const {
+  return size_;
+}
+
+int64_t TimeWindowedSum::Duration() const {
+  return duration_;
+}
+
+void TimeWindowedSum::CheckTime(int64_t timestamp) const {
+  if (timestamp < now_) {
+    throw WindowedSumOutOfOrder{};
+  }
+}
+
+void TimeWindowedSum::Reserve(size_t size) {
+  if (size <= timestamps_.size()) {
+    return;
+  }
+  const auto capacity = std::bit_ceil(std::max(size, kMinTimeRingCapacity));
+  std::vector<int64_t> timestamps(capacity);
+  std::vector<int> values(capacity);
+  for (size_t i = 0; i < size_; ++i) {
+    timestamps[i] = timestamps_[(tail_ + i) & mask_];
+    values[i] = values_[(tail_ + i) & mask_];
+  }
+  timestamps_ = std::move(timestamps);
+  values_ = std::move(values);
+  mask_ = capacity - 1;
+  tail_ = 0;
+}
+
+void TimeWindowedSum::Evict() {
+  if (now_ < std::numeric_limits<int64_t>::min() + duration_) {
+    return;
+  }
+  const auto limit = now_ - duration_;
+  size_t expired = 0;
+  while (expired < size_ && timestamps_[(tail_ + expired) & mask_] <= limit) {
+    ++expired;
+  }
+  if (expired > 0) {
+    sum_ -= RingSum(values_, tail_, expired);
+    tail_ = (tail_ + expired) & mask_;
+    size_ -= expired;
+  }
+}
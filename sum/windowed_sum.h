@@ -0,0 +1,75 @@
+#pragma once
+#ifndef WINDOWED_SUM_H
+#define WINDOWED_SUM_H
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+class WindowedSumOutOfOrder : public std::invalid_argument {
+ public:
+  WindowedSumOutOfOrder() : std::invalid_argument("WindowedSumOutOfOrder") {
+  }
+};
+
+// Exact int64 sum of the last Window() pushed values. Values live in a power-of-two ring buffer, each push adds the new
+// value and subtracts the evicted one, so the sum is never recomputed.
+class WindowedSum {
+ public:
+  explicit WindowedSum(size_t window);
+
+  void Push(int value);
+  // Same as pushing the values one by one, but the running sum is updated with two vectorized range sums (the new
+  // values and the evicted ones) and the ring with at most two block copies.
+  void Push(std::span<const int> values);
+  void Clear();
+
+  int64_t Sum() const;
+  size_t Size() const;
+  size_t Window() const;
+
+ private:
+  std::vector<int> ring_;
+  size_t mask_;
+  size_t window_;
+  size_t head_ = 0;  // ring position of the next value
+  size_t size_ = 0;
+  int64_t sum_ = 0;
+};
+
+// Exact int64 sum of the values pushed during the last Duration() time units: a value pushed with timestamp t is
+// counted while t > now - Duration(), where now is the latest timestamp passed to Push or Advance.
+// Timestamps must not decrease, otherwise WindowedSumOutOfOrder is thrown.
+class TimeWindowedSum {
+ public:
+  explicit TimeWindowedSum(int64_t duration);
+
+  void Push(int64_t timestamp, int value);
+  // Throws SumSizeMismatch if the spans differ in size.
+  void Push(std::span<const int64_t> timestamps, std::span<const int> values);
+  // Moves the clock forward, evicting values that fell out of the window.
+  void Advance(int64_t now);
+  void Clear();
+
+  int64_t Sum() const;
+  size_t Size() const;
+  int64_t Duration() const;
+
+ private:
+  void CheckTime(int64_t timestamp) const;
+  void Reserve(size_t size);
+  void Evict();
+
+  std::vector<int64_t> timestamps_;
+  std::vector<int> values_;
+  size_t mask_ = 0;
+  size_t tail_ = 0;  // ring position of the oldest value
+  size_t size_ = 0;
+  int64_t duration_;
+  int64_t now_;
+  int64_t sum_ = 0;
+};
+
+#endif